@@ -0,0 +1,55 @@
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include <time.h>
+#include "common.h"
+#include "model.h"
+#include "bench.h"
+
+static UINT64 startCycles;
+static UINT64 startNs;
+
+static UINT64 hostNs(void);
+
+
+
+static UINT64 hostNs(void)
+{
+struct timespec ts;
+
+clock_gettime(CLOCK_MONOTONIC, &ts);
+
+return (UINT64)ts.tv_sec * 1000000000u + (UINT64)ts.tv_nsec;
+}
+
+
+/*********************************************************************//**
+ * @brief       Start a measurement
+ **********************************************************************/
+void BENCH_Begin(void)
+{
+MODEL_ClearCount();
+startCycles = MODEL_Now64();
+startNs = hostNs();
+}
+
+
+/*********************************************************************//**
+ * @brief       End a measurement and print it
+ * @param[in]   name        Benchmark name
+ * @param[in]   params      JSON members describing the parameters, without
+ *                          braces, e.g. "\"word_bits\":8", may be ""
+ * @param[in]   iterations  Number of operations measured
+ **********************************************************************/
+void BENCH_End(const char *name, const char *params, UINT32 iterations)
+{
+UINT64 ns = hostNs() - startNs;
+UINT64 cycles = MODEL_Now64() - startCycles;
+MODEL_COUNT_Type count = MODEL_Count();
+double n = (iterations != 0) ? (double)iterations : 1.0;
+
+printf("{\"bench\":\"%s\",\"params\":{%s},\"iterations\":%u,\"cycles_per_op\":%.2f,"
+       "\"reads_per_op\":%.2f,\"writes_per_op\":%.2f,\"host_ns_per_op\":%.2f}\n",
+       name, params, iterations, (double)cycles / n, count.Reads / n,
+       count.Writes / n, (double)ns / n);
+}
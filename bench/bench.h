@@ -0,0 +1,25 @@
+#ifndef __bench_h
+#define __bench_h
+
+#include "common.h"
+
+
+/*------------- Benchmark measurement helpers --------------------------------*/
+/* NOTE:
+* A measurement covers the code between BENCH_Begin() and BENCH_End() and is
+* printed as one JSON object per line:
+*   {"bench":..., "params":{...}, "iterations":N, "cycles_per_op":...,
+*    "reads_per_op":..., "writes_per_op":..., "host_ns_per_op":...}
+* cycles_per_op is the modeled cycle count (register access cost, SPI
+* transfer time and explicit MODEL_Spend() work), reads/writes count register
+* accesses, and host_ns_per_op is the wall time of the host running the
+* driver code, which mostly reflects the CPU work between accesses.
+*/
+
+
+/* Benchmark functions --------------------------------------------------------*/
+void BENCH_Begin(void);
+void BENCH_End(const char *name, const char *params, UINT32 iterations);
+
+
+#endif /* __bench_h */
@@ -0,0 +1,115 @@
+/*
+ * GPIO driver benchmark: cost of every GPIO function on a modeled GRGPIO
+ * port, including the output shadow and the multi-port bulk functions.
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include "common.h"
+#include "leon_gpio.h"
+#include "model.h"
+#include "bench.h"
+
+#define ITERATIONS          (100000)
+
+static LEON_GPIO_TypeDef port[GPIO_BULK_MAX_PORTS];
+
+
+int main(void)
+{
+LEON_GPIO_TypeDef *ports[GPIO_BULK_MAX_PORTS];
+GPIO_SHADOW_Type shadow;
+GPIO_BULK_Type bulk;
+GPIO_IMAGE_Type image;
+volatile UINT32 sink = 0;
+char params[64];
+UINT32 n;
+UINT32 i;
+
+MODEL_Reset();
+for (i = 0; i < GPIO_BULK_MAX_PORTS; i++)
+    {
+    MODEL_GPIO_Init(&port[i]);
+    ports[i] = &port[i];
+    }
+
+BENCH_Begin();
+for (i = 0; i < ITERATIONS; i++)
+    {
+    GPIO_Init();
+    GPIO_Deinit();
+    }
+BENCH_End("gpio_init_deinit", "", ITERATIONS);
+
+BENCH_Begin();
+for (i = 0; i < ITERATIONS; i++)
+    {
+    GPIO_SetDir(&port[0], 1u << (i & 31), (UINT8)(i & 1));
+    }
+BENCH_End("gpio_set_dir", "", ITERATIONS);
+
+BENCH_Begin();
+for (i = 0; i < ITERATIONS; i++)
+    {
+    GPIO_SetValue(&port[0], 1);
+    GPIO_ClearValue(&port[0], 1);
+    }
+BENCH_End("gpio_toggle", "\"method\":\"set_clear\"", ITERATIONS);
+
+BENCH_Begin();
+for (i = 0; i < ITERATIONS; i++)
+    {
+    GPIO_OutputValue(&port[0], 1, (UINT8)(i & 1));
+    }
+BENCH_End("gpio_output_value", "", ITERATIONS);
+
+BENCH_Begin();
+for (i = 0; i < ITERATIONS; i++)
+    {
+    sink += GPIO_ReadValue(&port[0]);
+    }
+BENCH_End("gpio_read_value", "", ITERATIONS);
+
+GPIO_ShadowInit(&shadow, &port[0]);
+BENCH_Begin();
+for (i = 0; i < ITERATIONS; i++)
+    {
+    GPIO_ShadowSetValue(&shadow, 1);
+    GPIO_ShadowClearValue(&shadow, 1);
+    }
+BENCH_End("gpio_toggle", "\"method\":\"shadow\"", ITERATIONS);
+
+for (n = 1; n <= GPIO_BULK_MAX_PORTS; n++)
+    {
+    snprintf(params, sizeof(params), "\"ports\":%u", n);
+    GPIO_BulkInit(&bulk, ports, n);
+
+    BENCH_Begin();
+    for (i = 0; i < ITERATIONS; i++)
+        {
+        GPIO_BulkRead(&bulk, &image);
+        }
+    BENCH_End("gpio_bulk_read", params, ITERATIONS);
+
+    BENCH_Begin();
+    for (i = 0; i < ITERATIONS; i++)
+        {
+        GPIO_BulkWrite(&bulk, &image);
+        }
+    BENCH_End("gpio_bulk_write", params, ITERATIONS);
+
+    /* Reference: the same snapshot with one GPIO_ReadValue() per port */
+    BENCH_Begin();
+    for (i = 0; i < ITERATIONS; i++)
+        {
+        UINT32 p;
+        for (p = 0; p < n; p++)
+            {
+            image.Word[p] = GPIO_ReadValue(ports[p]);
+            }
+        }
+    BENCH_End("gpio_per_port_read", params, ITERATIONS);
+    }
+
+return (int)(sink & 0);
+}
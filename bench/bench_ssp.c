@@ -0,0 +1,192 @@
+/*
+ * SSP driver benchmark on a modeled GRSPI core in master loopback mode:
+ * - SSP_Init() including the setSSPclock() divider search, per target clock
+ * - SSP_Cmd() enable/disable
+ * - per word cost of SSP_SendData(), SSP_GetStatus()/SSP_WaitEvent() and
+ *   SSP_ReceiveData() over word lengths and FIFO depths
+ * - per word cost of a chip select transaction: SSP_CS_Select(), one queue
+ *   of SSP_BusSendData() and SSP_CS_Deselect(), with the received words read
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include "common.h"
+#include "leon_ssp.h"
+#include "model.h"
+#include "bench.h"
+#include "HAL.h"
+
+#define INIT_ITERATIONS     (100000)
+#define WORDS               (4096)
+
+static MODEL_SSP_Type ssp;
+
+
+/*********************************************************************//**
+ * @brief       Configure the modeled core as enabled master
+ **********************************************************************/
+static void setup(UINT32 depth, UINT32 databit, UINT32 clock)
+{
+SSP_CFG_Type cfg;
+
+MODEL_Reset();
+MODEL_SSP_Init(&ssp, depth);
+
+SSP_ConfigStructInit(&cfg);
+cfg.Databit = databit;
+cfg.ClockRate = clock;
+SSP_Init(&ssp.Regs, &cfg);
+SSP_Cmd(&ssp.Regs, ENABLE);
+}
+
+
+/*********************************************************************//**
+ * @brief       Send and receive WORDS words, depth words per burst
+ * @param[in]   depth       Words queued before reading back
+ * @param[in]   useWait     Wait with SSP_WaitEvent() instead of polling
+ *                          SSP_GetStatus()
+ * @return      Sum of the received words
+ **********************************************************************/
+static UINT32 transfer(UINT32 depth, UINT32 useWait)
+{
+UINT32 sum = 0;
+UINT32 done = 0;
+UINT32 i;
+
+while (done < WORDS)
+    {
+    for (i = 0; i < depth; i++)
+        {
+        SSP_SendData(&ssp.Regs, done + i);
+        }
+
+    for (i = 0; i < depth; i++)
+        {
+        if (useWait)
+            {
+            SSP_WaitEvent(&ssp.Regs, SSP_EVENT_NE, SSP_WAIT_FOREVER, NULL);
+            }
+        else
+            {
+            while (SSP_GetStatus(&ssp.Regs, SSP_EVENT_NE) == RESET)
+                {
+                }
+            }
+        sum += SSP_ReceiveData(&ssp.Regs);
+        }
+
+    done += depth;
+    }
+
+return sum;
+}
+
+
+/*********************************************************************//**
+ * @brief       Send WORDS words in chip select transactions of depth words
+ * @return      Sum of the received words
+ **********************************************************************/
+static UINT32 busTransfer(UINT32 depth)
+{
+SSP_BUS_Type bus;
+SSP_CS_Type cs;
+UINT32 sum = 0;
+UINT32 done = 0;
+UINT32 i;
+
+SSP_BusInit(&bus, &ssp.Regs);
+SSP_CS_InitNative(&cs, &ssp.Regs, 0);
+
+while (done < WORDS)
+    {
+    SSP_CS_Select(&bus, &cs);
+    for (i = 0; i < depth; i++)
+        {
+        SSP_BusSendData(&bus, done + i);
+        }
+    SSP_CS_Deselect(&bus);
+
+    while (SSP_GetStatus(&ssp.Regs, SSP_EVENT_NE) == SET)
+        {
+        sum += SSP_ReceiveData(&ssp.Regs);
+        }
+
+    done += depth;
+    }
+
+return sum;
+}
+
+
+int main(void)
+{
+static const UINT32 clocks[] = { 25000000, 12500000, 1000000, 100000, 10000, 1000 };
+static const UINT32 bits[] = { 4, 8, 12, 16, 32 };
+static const UINT32 depths[] = { 1, 2, 4, 8, 16, 32, 64 };
+static const char *waits[] = { "get_status", "wait_event" };
+volatile UINT32 sink = 0;
+SSP_CFG_Type cfg;
+char params[96];
+UINT32 c;
+UINT32 b;
+UINT32 d;
+UINT32 w;
+UINT32 i;
+
+MODEL_Reset();
+MODEL_SSP_Init(&ssp, 8);
+SSP_ConfigStructInit(&cfg);
+
+for (c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+    cfg.ClockRate = clocks[c];
+    snprintf(params, sizeof(params), "\"clock_hz\":%u", clocks[c]);
+
+    BENCH_Begin();
+    for (i = 0; i < INIT_ITERATIONS; i++)
+        {
+        SSP_Init(&ssp.Regs, &cfg);
+        }
+    BENCH_End("ssp_init", params, INIT_ITERATIONS);
+    }
+
+BENCH_Begin();
+for (i = 0; i < INIT_ITERATIONS; i++)
+    {
+    SSP_Cmd(&ssp.Regs, ENABLE);
+    SSP_Cmd(&ssp.Regs, DISABLE);
+    }
+BENCH_End("ssp_cmd", "\"sequence\":\"enable_disable\"", INIT_ITERATIONS);
+
+for (w = 0; w < 2; w++)
+    {
+    for (b = 0; b < sizeof(bits) / sizeof(bits[0]); b++)
+        {
+        for (d = 0; d < sizeof(depths) / sizeof(depths[0]); d++)
+            {
+            setup(depths[d], (bits[b] == 32) ? SSP_DATABIT_32 : SSP_MODE_LEN(bits[b]),
+                  CPU_CLOCK_HZ / 4);
+            snprintf(params, sizeof(params),
+                     "\"wait\":\"%s\",\"word_bits\":%u,\"fifo_depth\":%u,\"clock_hz\":%lu",
+                     waits[w], bits[b], depths[d], (unsigned long)(CPU_CLOCK_HZ / 4));
+
+            BENCH_Begin();
+            sink += transfer(depths[d], w);
+            BENCH_End("ssp_transfer_word", params, WORDS);
+            }
+        }
+    }
+
+for (d = 0; d < sizeof(depths) / sizeof(depths[0]); d++)
+    {
+    setup(depths[d], SSP_MODE_LEN(8), CPU_CLOCK_HZ / 4);
+    snprintf(params, sizeof(params), "\"word_bits\":8,\"fifo_depth\":%u,\"clock_hz\":%lu",
+             depths[d], (unsigned long)(CPU_CLOCK_HZ / 4));
+
+    BENCH_Begin();
+    sink += busTransfer(depths[d]);
+    BENCH_End("ssp_bus_transfer_word", params, WORDS);
+    }
+
+return (int)(sink & 0);
+}
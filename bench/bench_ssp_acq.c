@@ -0,0 +1,91 @@
+/*
+ * Acquisition pipeline benchmark: cost of SSP_ACQ_Scan() per channel sample
+ * over CIC orders, decimation ratios and channel counts, on a modeled GRSPI
+ * core in loopback at a quarter of the system clock. The consumer releases
+ * every frame so that none is dropped.
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include "common.h"
+#include "leon_ssp_acq.h"
+#include "model.h"
+#include "bench.h"
+#include "HAL.h"
+
+#define SCANS               (4096)
+
+static MODEL_SSP_Type ssp;
+static SSP_ACQ_FRAME_Type frames[16];
+
+
+int main(void)
+{
+static const UINT32 channels[] = { 1, 4, 16 };
+static const UINT32 decims[] = { 0, 2, 4 };
+static UINT32 command[SSP_ACQ_MAX_CHANNELS];
+volatile UINT32 sink = 0;
+const SSP_ACQ_FRAME_Type *pFrame;
+SSP_CFG_Type sspCfg;
+SSP_ACQ_CFG_Type cfg;
+SSP_ACQ_RING_Type ring;
+SSP_ACQ_Type acq;
+char params[128];
+UINT32 order;
+UINT32 c;
+UINT32 d;
+UINT32 i;
+
+for (i = 0; i < SSP_ACQ_MAX_CHANNELS; i++)
+    {
+    command[i] = i << 12;
+    }
+
+for (order = 1; order <= SSP_ACQ_MAX_ORDER; order++)
+    {
+    for (d = 0; d < sizeof(decims) / sizeof(decims[0]); d++)
+        {
+        for (c = 0; c < sizeof(channels) / sizeof(channels[0]); c++)
+            {
+            MODEL_Reset();
+            MODEL_SSP_Init(&ssp, 8);
+            SSP_ConfigStructInit(&sspCfg);
+            sspCfg.Databit = SSP_MODE_LEN(16);
+            sspCfg.ClockRate = CPU_CLOCK_HZ / 4;
+            SSP_Init(&ssp.Regs, &sspCfg);
+            SSP_Cmd(&ssp.Regs, ENABLE);
+
+            cfg.NumChannels = channels[c];
+            cfg.pCommand = command;
+            cfg.Latency = 0;
+            cfg.Shift = 0;
+            cfg.Bits = 12;
+            cfg.Signed = FALSE;
+            cfg.Order = order;
+            cfg.DecimLog2 = decims[d];
+            cfg.Timeout = SSP_WAIT_FOREVER;
+            SSP_ACQ_RingInit(&ring, frames, 16);
+            SSP_ACQ_Init(&acq, &ssp.Regs, &cfg, &ring);
+
+            snprintf(params, sizeof(params),
+                     "\"order\":%u,\"decim\":%u,\"channels\":%u,\"fifo_depth\":8,\"clock_hz\":%lu",
+                     order, 1u << decims[d], channels[c], (unsigned long)(CPU_CLOCK_HZ / 4));
+
+            BENCH_Begin();
+            for (i = 0; i < SCANS; i++)
+                {
+                SSP_ACQ_Scan(&acq);
+                pFrame = SSP_ACQ_RingPeek(&ring);
+                if (pFrame != NULL)
+                    {
+                    sink += (UINT32)pFrame->Sample[0];
+                    SSP_ACQ_RingRelease(&ring);
+                    }
+                }
+            BENCH_End("ssp_acq_sample", params, SCANS * channels[c]);
+            }
+        }
+    }
+
+return (int)(sink & 0);
+}
@@ -0,0 +1,226 @@
+/*
+ * Sustained SPI slave receive rate before overruns.
+ *
+ * An external master sends 16-bit words at a fixed period into a modeled
+ * SSP core in slave mode while the application alternates interruptible
+ * frame processing with short critical sections. For each FIFO depth the
+ * shortest word period that runs without a single OV event is searched for:
+ * - "poll": the main loop drains RX with SSP_GetStatus()/SSP_ReceiveData()
+ *   between work chunks
+ * - "slave_irq": SSP_SLV_IRQHandler() drains the queue from the NE interrupt
+ *   into ping-pong buffers
+ * Each variant is then measured at its shortest period and printed through
+ * BENCH_End() with one received word per operation, so cycles_per_op is the
+ * sustained word period and CPU_CLOCK_HZ / cycles_per_op the word rate.
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include "common.h"
+#include "leon_ssp_slave.h"
+#include "model.h"
+#include "bench.h"
+#include "HAL.h"
+
+#define FRAME_WORDS         (64)
+#define FRAMES              (200)
+#define WORK_CYCLES_WORD    (8)     /* application cost per received word  */
+#define WORK_CHUNK          (2000)  /* main loop work between polls        */
+#define CRITICAL_CYCLES     (150)   /* interrupts disabled, per frame      */
+#define IRQ_ENTRY_CYCLES    (40)    /* trap entry and register window save */
+#define IRQ_EXIT_CYCLES     (30)
+#define QUANTUM             (8)     /* interrupt sampling granularity      */
+#define MAX_PERIOD          (20000)
+
+static MODEL_SSP_Type ssp;
+static SSP_SLV_Type slv;
+static UINT32 buf[2][FRAME_WORDS];
+static UINT32 pollBuf[FRAME_WORDS];
+
+
+
+/*********************************************************************//**
+ * @brief       Run CPU work, taking the SSP interrupt when enabled
+ **********************************************************************/
+static void cpuRun(UINT32 cycles, UINT32 irqEnabled)
+{
+UINT32 q;
+
+while (cycles)
+    {
+    q = (cycles < QUANTUM) ? cycles : QUANTUM;
+    MODEL_Spend(q);
+    cycles -= q;
+
+    if (irqEnabled && MODEL_SSP_IrqPending(&ssp))
+        {
+        MODEL_Spend(IRQ_ENTRY_CYCLES);
+        SSP_SLV_IRQHandler(&slv);
+        MODEL_Spend(IRQ_EXIT_CYCLES);
+        }
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Configure the modeled core as slave fed every period cycles
+ **********************************************************************/
+static void setup(UINT32 depth, UINT32 period)
+{
+SSP_CFG_Type cfg;
+
+MODEL_Reset();
+MODEL_SSP_Init(&ssp, depth);
+ssp.SlavePeriod = period;
+
+SSP_ConfigStructInit(&cfg);
+cfg.Mode = SSP_SLAVE_MODE;
+cfg.Databit = SSP_DATABIT_16;
+SSP_Init(&ssp.Regs, &cfg);
+SSP_Cmd(&ssp.Regs, ENABLE);
+}
+
+
+/*********************************************************************//**
+ * @brief       Word-at-a-time polling receiver
+ * @return      Number of OV events
+ **********************************************************************/
+static UINT32 runPoll(void)
+{
+UINT32 words = 0;
+UINT32 pos = 0;
+UINT32 ov = 0;
+
+while (words < FRAME_WORDS * FRAMES)
+    {
+    while (SSP_GetStatus(&ssp.Regs, SSP_EVENT_NE) == SET)
+        {
+        pollBuf[pos++] = SSP_ReceiveData(&ssp.Regs);
+        words++;
+        if (pos == FRAME_WORDS)
+            {
+            pos = 0;
+            cpuRun(CRITICAL_CYCLES, 0);
+            cpuRun(FRAME_WORDS * WORK_CYCLES_WORD, 0);
+            }
+        }
+
+    if (SSP_ReadEvents(&ssp.Regs) & SSP_EVENT_OV)
+        {
+        ov++;
+        }
+
+    cpuRun(WORK_CHUNK, 0);
+    }
+
+return ov;
+}
+
+
+/*********************************************************************//**
+ * @brief       Interrupt driven ping-pong receiver
+ * @return      Number of OV events, dropped frames included
+ **********************************************************************/
+static UINT32 runIrq(void)
+{
+SSP_SLV_CFG_Type cfg = { FRAME_WORDS, 0, 0 };
+SSP_SLV_FRAME_Type *pFrame;
+UINT32 frames = 0;
+
+SSP_SLV_Init(&slv, &ssp.Regs, &cfg, buf[0], buf[1]);
+
+while ((frames + slv.Dropped) < FRAMES)
+    {
+    pFrame = SSP_SLV_GetFrame(&slv);
+    if (pFrame == NULL)
+        {
+        cpuRun(QUANTUM, 1);
+        continue;
+        }
+
+    cpuRun(CRITICAL_CYCLES, 0);
+    cpuRun(FRAME_WORDS * WORK_CYCLES_WORD, 1);
+    SSP_SLV_ReleaseFrame(&slv, pFrame);
+    frames++;
+    }
+
+SSP_SLV_Stop(&slv);
+
+return slv.Overruns + slv.Dropped;
+}
+
+
+/*********************************************************************//**
+ * @brief       Run a receiver on a freshly configured core
+ * @return      Number of OV events
+ **********************************************************************/
+static UINT32 overruns(UINT32 (*pRun)(void), UINT32 depth, UINT32 period)
+{
+setup(depth, period);
+
+return pRun();
+}
+
+
+/*********************************************************************//**
+ * @brief       Shortest word period without overruns (binary search)
+ **********************************************************************/
+static UINT32 minPeriod(UINT32 (*pRun)(void), UINT32 depth)
+{
+UINT32 lo = 1;
+UINT32 hi = MAX_PERIOD;
+UINT32 mid;
+
+if (overruns(pRun, depth, hi) != 0)
+    {
+    return 0;
+    }
+
+while (lo < hi)
+    {
+    mid = (lo + hi) / 2;
+    if (overruns(pRun, depth, mid) == 0)
+        hi = mid;
+    else
+        lo = mid + 1;
+    }
+
+return hi;
+}
+
+
+int main(void)
+{
+static const UINT32 depths[] = { 4, 8, 16, 32, 64 };
+static const char *names[] = { "poll", "slave_irq" };
+UINT32 (*runs[])(void) = { runPoll, runIrq };
+char params[96];
+UINT32 d;
+UINT32 v;
+UINT32 period;
+
+for (v = 0; v < 2; v++)
+    {
+    for (d = 0; d < sizeof(depths) / sizeof(depths[0]); d++)
+        {
+        period = minPeriod(runs[v], depths[d]);
+        if (period == 0)
+            {
+            fprintf(stderr, "ssp_slave_rx %s depth %u: overruns at any period\n",
+                    names[v], depths[d]);
+            continue;
+            }
+
+        snprintf(params, sizeof(params),
+                 "\"variant\":\"%s\",\"fifo_depth\":%u,\"word_period_cycles\":%u",
+                 names[v], depths[d], period);
+
+        setup(depths[d], period);
+        BENCH_Begin();
+        runs[v]();
+        BENCH_End("ssp_slave_rx_word", params, FRAME_WORDS * FRAMES);
+        }
+    }
+
+return 0;
+}
@@ -0,0 +1,350 @@
+
+/* Includes ------------------------------------------------------------------- */
+#include <string.h>
+#include "common.h"
+#include "leon_ssp.h"
+#include "leon_trace.h"
+#include "model.h"
+
+static UINT64 now;
+static MODEL_COUNT_Type count;
+static MODEL_SSP_Type *sspModel[MODEL_MAX_DEVICES];
+static UINT32 numSSP;
+static LEON_GPIO_TypeDef *gpioModel[MODEL_MAX_DEVICES];
+static UINT32 numGPIO;
+
+static UINT64 wordCycles(MODEL_SSP_Type *pModel);
+static UINT64 gapCycles(MODEL_SSP_Type *pModel);
+static void pushRx(MODEL_SSP_Type *pModel, UINT32 word);
+static void startShift(MODEL_SSP_Type *pModel);
+static void advance(MODEL_SSP_Type *pModel);
+static MODEL_SSP_Type *findSSP(const volatile UINT32 *pReg);
+static UINT32 eventValue(MODEL_SSP_Type *pModel);
+
+
+
+/*********************************************************************//**
+ * @brief       Forget all modeled blocks and restart the clock
+ **********************************************************************/
+void MODEL_Reset(void)
+{
+now = 0;
+numSSP = 0;
+numGPIO = 0;
+MODEL_ClearCount();
+}
+
+
+/*********************************************************************//**
+ * @brief       Model clock, in CPU cycles
+ **********************************************************************/
+UINT32 MODEL_Now(void)
+{
+return (UINT32)now;
+}
+
+UINT64 MODEL_Now64(void)
+{
+return now;
+}
+
+
+/*********************************************************************//**
+ * @brief       Account CPU work that does not access registers
+ **********************************************************************/
+void MODEL_Spend(UINT32 cycles)
+{
+UINT32 i;
+
+now += cycles;
+
+for (i = 0; i < numSSP; i++)
+    {
+    advance(sspModel[i]);
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Access counters since the last MODEL_ClearCount()
+ **********************************************************************/
+MODEL_COUNT_Type MODEL_Count(void)
+{
+return count;
+}
+
+void MODEL_ClearCount(void)
+{
+count.Reads = 0;
+count.Writes = 0;
+}
+
+
+/*********************************************************************//**
+ * @brief       Add a modeled SSP core with the given queue depth
+ **********************************************************************/
+void MODEL_SSP_Init(MODEL_SSP_Type *pModel, UINT32 depth)
+{
+memset(pModel, 0, sizeof(*pModel));
+
+pModel->Depth = (depth > MODEL_MAX_FIFO) ? MODEL_MAX_FIFO : depth;
+pModel->Regs.CAP = SSP_CAP_SSSZ(8) | SSP_CAP_SSEN | SSP_CAP_FDEPTH((pModel->Depth - 1)) | 5;
+pModel->Regs.SLAVESEL = 0xFFFFFFFF;
+
+sspModel[numSSP++] = pModel;
+}
+
+
+/*********************************************************************//**
+ * @brief       Add a modeled GPIO port
+ **********************************************************************/
+void MODEL_GPIO_Init(LEON_GPIO_TypeDef *pGPIO)
+{
+memset((void *)pGPIO, 0, sizeof(*pGPIO));
+
+gpioModel[numGPIO++] = pGPIO;
+}
+
+
+/*********************************************************************//**
+ * @brief       Level of the interrupt line of a modeled SSP core
+ **********************************************************************/
+UINT32 MODEL_SSP_IrqPending(MODEL_SSP_Type *pModel)
+{
+advance(pModel);
+
+return (eventValue(pModel) & pModel->Regs.MASK) != 0;
+}
+
+
+/*********************************************************************//**
+ * @brief       Duration of one word from the Mode register
+ **********************************************************************/
+static UINT64 wordCycles(MODEL_SSP_Type *pModel)
+{
+UINT32 mode = pModel->Regs.MODE;
+UINT32 len = (mode >> 20) & SSP_MODE_LEN_MASK;
+UINT64 sck = ((mode & SSP_MODE_FACT) ? 2 : 4) * (((mode >> 16) & SSP_MODE_PM_MASK) + 1);
+
+if (mode & SSP_MODE_DIV16)
+    sck *= 16;
+
+return sck * ((len == 0) ? 32 : (len + 1));
+}
+
+
+/*********************************************************************//**
+ * @brief       Clock gap (CG) inserted before a word that was queued while
+ *              the previous one was transferred
+ **********************************************************************/
+static UINT64 gapCycles(MODEL_SSP_Type *pModel)
+{
+UINT32 mode = pModel->Regs.MODE;
+UINT64 sck = ((mode & SSP_MODE_FACT) ? 2 : 4) * (((mode >> 16) & SSP_MODE_PM_MASK) + 1);
+
+if (mode & SSP_MODE_DIV16)
+    sck *= 16;
+
+return sck * ((mode >> 7) & SSP_MODE_CG_MASK);
+}
+
+
+static void pushRx(MODEL_SSP_Type *pModel, UINT32 word)
+{
+if (pModel->RxCount == pModel->Depth)
+    {
+    pModel->Sticky |= SSP_EVENT_OV;
+    return;
+    }
+
+pModel->Rx[(pModel->RxHead + pModel->RxCount++) % MODEL_MAX_FIFO] = word;
+}
+
+
+static void startShift(MODEL_SSP_Type *pModel)
+{
+UINT32 mode = pModel->Regs.MODE;
+
+if (pModel->Shifting || (pModel->TxCount == 0) ||
+    !(mode & SSP_MODE_EN) || !(mode & SSP_MODE_MS))
+    {
+    return;
+    }
+
+pModel->ShiftWord = pModel->Tx[pModel->TxHead];
+pModel->TxHead = (pModel->TxHead + 1) % MODEL_MAX_FIFO;
+pModel->TxCount--;
+pModel->Shifting = 1;
+pModel->ShiftEnd = now + wordCycles(pModel);
+}
+
+
+/*********************************************************************//**
+ * @brief       Bring a modeled SSP core up to the model clock
+ **********************************************************************/
+static void advance(MODEL_SSP_Type *pModel)
+{
+UINT64 end;
+
+while (pModel->Shifting && (pModel->ShiftEnd <= now))
+    {
+    end = pModel->ShiftEnd;
+    pushRx(pModel, (pModel->pDevice != NULL) ?
+           pModel->pDevice(pModel->ShiftWord, pModel->pArg) : pModel->ShiftWord);
+    pModel->Shifting = 0;
+
+    if (pModel->TxCount)
+        {
+        /* Queued transfer, timed from the end of the previous one */
+        startShift(pModel);
+        pModel->ShiftEnd = end + gapCycles(pModel) + wordCycles(pModel);
+        }
+    else if (pModel->LstArmed)
+        {
+        pModel->LstArmed = 0;
+        pModel->Sticky |= SSP_EVENT_LT;
+        }
+    }
+
+if ((pModel->SlavePeriod != 0) && (pModel->Regs.MODE & SSP_MODE_EN) &&
+    !(pModel->Regs.MODE & SSP_MODE_MS))
+    {
+    while (pModel->SlaveNext <= now)
+        {
+        pushRx(pModel, pModel->SlaveWord++);
+        pModel->SlaveNext += pModel->SlavePeriod;
+        }
+    }
+}
+
+
+static MODEL_SSP_Type *findSSP(const volatile UINT32 *pReg)
+{
+UINT32 i;
+unsigned long off;
+
+for (i = 0; i < numSSP; i++)
+    {
+    off = (unsigned long)pReg - (unsigned long)&sspModel[i]->Regs;
+    if (off < sizeof(LEON_SSP_TypeDef))
+        {
+        return sspModel[i];
+        }
+    }
+
+return NULL;
+}
+
+
+static UINT32 eventValue(MODEL_SSP_Type *pModel)
+{
+UINT32 event = pModel->Sticky;
+
+if (pModel->Shifting)
+    event |= SSP_EVENT_TIP;
+if (pModel->RxCount)
+    event |= SSP_EVENT_NE;
+if (pModel->TxCount < pModel->Depth)
+    event |= SSP_EVENT_NF;
+
+return event;
+}
+
+
+/*********************************************************************//**
+ * @brief       Register read hook (replaces leon_trace.c in the benchmarks)
+ **********************************************************************/
+UINT32 LEON_TraceRead(const volatile UINT32 *pReg)
+{
+MODEL_SSP_Type *pModel;
+UINT32 value;
+
+now += MODEL_APB_READ_CYCLES;
+count.Reads++;
+
+pModel = findSSP(pReg);
+if (pModel == NULL)
+    {
+    return *pReg;
+    }
+
+advance(pModel);
+
+if (pReg == &pModel->Regs.EVENT)
+    {
+    return eventValue(pModel);
+    }
+
+if (pReg == &pModel->Regs.RX)
+    {
+    if (pModel->RxCount == 0)
+        {
+        return pModel->Regs.RX;
+        }
+    value = pModel->Rx[pModel->RxHead];
+    pModel->RxHead = (pModel->RxHead + 1) % MODEL_MAX_FIFO;
+    pModel->RxCount--;
+    pModel->Regs.RX = value;
+    return value;
+    }
+
+return *pReg;
+}
+
+
+/*********************************************************************//**
+ * @brief       Register write hook (replaces leon_trace.c in the benchmarks)
+ **********************************************************************/
+void LEON_TraceWrite(volatile UINT32 *pReg, UINT32 value)
+{
+MODEL_SSP_Type *pModel;
+
+now += MODEL_APB_WRITE_CYCLES;
+count.Writes++;
+
+pModel = findSSP(pReg);
+if (pModel == NULL)
+    {
+    *pReg = value;
+    return;
+    }
+
+advance(pModel);
+
+if (pReg == &pModel->Regs.EVENT)
+    {
+    pModel->Sticky &= ~(value & SSP_EVENT_W1C);
+    }
+else if (pReg == &pModel->Regs.CMD)
+    {
+    if (value & SSP_CMD_LST)
+        {
+        pModel->LstArmed = 1;
+        }
+    }
+else if (pReg == &pModel->Regs.TX)
+    {
+    if (pModel->TxCount < pModel->Depth)
+        {
+        pModel->Tx[(pModel->TxHead + pModel->TxCount++) % MODEL_MAX_FIFO] = value;
+        }
+    startShift(pModel);
+    }
+else if (pReg == &pModel->Regs.MODE)
+    {
+    if (!(value & SSP_MODE_EN))
+        {
+        pModel->Shifting = 0;
+        }
+    pModel->Regs.MODE = value;
+    if ((value & SSP_MODE_EN) && (pModel->SlaveNext < now))
+        {
+        pModel->SlaveNext = now + pModel->SlavePeriod;
+        }
+    startShift(pModel);
+    }
+else if (pReg != &pModel->Regs.CAP)
+    {
+    *pReg = value;
+    }
+}
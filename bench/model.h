@@ -0,0 +1,78 @@
+#ifndef __model_h
+#define __model_h
+
+#include "common.h"
+#include "leon_ssp.h"
+
+
+/*------------- Modeled register blocks for host benchmarks ------------------*/
+/* NOTE:
+* The drivers are built with LEON_TRACE so every register access goes through
+* LEON_TraceRead()/LEON_TraceWrite(). This file implements those two functions
+* instead of leon_trace.c: accesses to a modeled SSP core get FIFO, EVENT and
+* transfer timing semantics, accesses to a modeled GPIO port are plain memory.
+* Every access advances the model clock by the APB access cost and is counted.
+*/
+
+
+/*********************************************************************//**
+ * Macro defines for the model
+ **********************************************************************/
+#define MODEL_MAX_FIFO          (256)
+#define MODEL_MAX_DEVICES       (8)
+
+/** Cost of an APB access seen from a LEON3 at 50 MHz, in CPU cycles */
+#ifndef MODEL_APB_READ_CYCLES
+#define MODEL_APB_READ_CYCLES   (6)
+#endif
+#ifndef MODEL_APB_WRITE_CYCLES
+#define MODEL_APB_WRITE_CYCLES  (4)
+#endif
+
+
+/** @brief Modeled SSP core */
+typedef struct {
+    LEON_SSP_TypeDef Regs;             /** Register storage                */
+    UINT32 Depth;                      /** Words per queue (FDEPTH+1)      */
+    UINT32 Tx[MODEL_MAX_FIFO];
+    UINT32 TxHead;
+    UINT32 TxCount;
+    UINT32 Rx[MODEL_MAX_FIFO];
+    UINT32 RxHead;
+    UINT32 RxCount;
+    UINT32 Sticky;                     /** LT, OV, UN, MME                 */
+    UINT32 LstArmed;                   /** CMD.LST written                 */
+    UINT32 Shifting;                   /** Master transfer in progress     */
+    UINT32 ShiftWord;                  /** Word being transferred          */
+    UINT64 ShiftEnd;                   /** End of the current transfer     */
+    UINT64 SlavePeriod;                /** Slave mode: cycles between words
+                                       sent by the external master, 0: off */
+    UINT64 SlaveNext;                  /** Time of the next external word  */
+    UINT32 SlaveWord;                  /** Next word sent by the master    */
+    UINT32 (*pDevice)(UINT32 tx, void *pArg);
+                                       /** Attached device in master mode,
+                                       NULL for loopback                   */
+    void *pArg;
+} MODEL_SSP_Type;
+
+
+/** @brief Access counters of one modeled block */
+typedef struct {
+    UINT32 Reads;
+    UINT32 Writes;
+} MODEL_COUNT_Type;
+
+
+/* Model functions ------------------------------------------------------------*/
+void MODEL_Reset(void);
+UINT32 MODEL_Now(void);
+UINT64 MODEL_Now64(void);
+void MODEL_Spend(UINT32 cycles);
+void MODEL_SSP_Init(MODEL_SSP_Type *pModel, UINT32 depth);
+void MODEL_GPIO_Init(LEON_GPIO_TypeDef *pGPIO);
+UINT32 MODEL_SSP_IrqPending(MODEL_SSP_Type *pModel);
+MODEL_COUNT_Type MODEL_Count(void);
+void MODEL_ClearCount(void);
+
+
+#endif /* __model_h */
@@ -0,0 +1,16 @@
+#ifndef __HAL_h
+#define __HAL_h
+
+/* Host stand-in for the target HAL.h, used by the benchmarks only. Time is
+ * the cycle count of the modeled register block (see bench/model.h). */
+#include "model.h"
+
+#define CPU_CLOCK_HZ        (50000000UL)
+#define SSP_CYCLE_COUNT()   MODEL_Now()
+#define SSP_DELAY_CYCLES(n) MODEL_Spend(n)
+
+/* The host tests run the drivers from a single thread */
+#define LEON_TRACE_LOCK()
+#define LEON_TRACE_UNLOCK()
+
+#endif /* __HAL_h */
@@ -0,0 +1,21 @@
+#ifndef __common_h
+#define __common_h
+
+/* Host stand-in for the target common.h, used by the benchmarks only */
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t   UINT8;
+typedef int8_t    INT8;
+typedef uint16_t  UINT16;
+typedef int16_t   INT16;
+typedef uint32_t  UINT32;
+typedef int32_t   INT32;
+typedef uint64_t  UINT64;
+typedef int64_t   INT64;
+typedef int       BOOLEAN;
+
+#define TRUE      (1)
+#define FALSE     (0)
+
+#endif /* __common_h */
@@ -0,0 +1,263 @@
+/*
+ * Acquisition pipeline test on a modeled GRSPI core with an attached ADC:
+ * - the CIC output matches a direct FIR reference (the CIC impulse response
+ *   is the N-fold convolution of a 2^DecimLog2 boxcar) for signed and
+ *   unsigned samples, for every order and a pipelined converter
+ * - after a scan aborted by a timeout the channel order is recovered
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include "common.h"
+#include "leon_ssp_acq.h"
+#include "model.h"
+
+#define CHANNELS        (3)
+#define BITS            (12)
+#define SHIFT           (2)
+#define FRAMES          (12)
+#define MAX_SCANS       (FRAMES << 3)
+#define MAX_TAPS        (SSP_ACQ_MAX_ORDER * 8)
+
+/** @brief Modeled ADC: the command word is the channel number. The input
+ * signal only changes between scans, so the trailing conversion of a
+ * pipelined converter sees the same value as the first one. */
+typedef struct {
+    UINT32 Latency;
+    UINT32 Prev;                       /** Previous command              */
+    UINT32 Scan;                       /** Scan being converted          */
+    INT32 Value[CHANNELS][MAX_SCANS];  /** Input of each channel, per scan */
+} ADC_Type;
+
+static const UINT32 command[CHANNELS] = { 0, 1, 2 };
+static MODEL_SSP_Type ssp;
+static ADC_Type adc;
+static int fail;
+
+
+/*********************************************************************//**
+ * @brief       Device hook: convert the channel named by the command, the
+ *              result comes Latency words later
+ **********************************************************************/
+static UINT32 convert(UINT32 tx, void *pArg)
+{
+ADC_Type *pAdc = (ADC_Type *)pArg;
+UINT32 ch = pAdc->Latency ? pAdc->Prev : tx;
+
+pAdc->Prev = tx;
+
+return ((UINT32)pAdc->Value[ch][pAdc->Scan % MAX_SCANS] & ((1u << BITS) - 1)) << SHIFT;
+}
+
+
+static void check(const char *name, int ok)
+{
+printf("%-44s %s\n", name, ok ? "ok" : "FAIL");
+fail |= !ok;
+}
+
+
+static void setup(SSP_ACQ_Type *pAcq, SSP_ACQ_RING_Type *pRing, SSP_ACQ_FRAME_Type *pFrames,
+                  UINT32 order, UINT32 decimLog2, BOOLEAN isSigned, UINT32 latency)
+{
+SSP_CFG_Type sspCfg;
+SSP_ACQ_CFG_Type cfg;
+
+MODEL_Reset();
+MODEL_SSP_Init(&ssp, 4);
+ssp.pDevice = convert;
+ssp.pArg = &adc;
+
+SSP_ConfigStructInit(&sspCfg);
+sspCfg.Databit = SSP_MODE_LEN(16);
+sspCfg.ClockRate = 1000000;
+SSP_Init(&ssp.Regs, &sspCfg);
+SSP_Cmd(&ssp.Regs, ENABLE);
+
+adc.Scan = 0;
+adc.Latency = latency;
+adc.Prev = 0;
+
+cfg.NumChannels = CHANNELS;
+cfg.pCommand = command;
+cfg.Latency = latency;
+cfg.Shift = SHIFT;
+cfg.Bits = BITS;
+cfg.Signed = isSigned;
+cfg.Order = order;
+cfg.DecimLog2 = decimLog2;
+cfg.Timeout = SSP_WAIT_FOREVER;
+
+SSP_ACQ_RingInit(pRing, pFrames, 16);
+if (SSP_ACQ_Init(pAcq, &ssp.Regs, &cfg, pRing) != SUCCESS)
+    {
+    check("SSP_ACQ_Init", 0);
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Compare every frame with the reference decimator output
+ **********************************************************************/
+static void testCIC(UINT32 order, UINT32 decimLog2, BOOLEAN isSigned, UINT32 latency)
+{
+static SSP_ACQ_FRAME_Type frames[16];
+SSP_ACQ_RING_Type ring;
+SSP_ACQ_Type acq;
+const SSP_ACQ_FRAME_Type *pFrame;
+INT64 h[MAX_TAPS];
+INT64 t[MAX_TAPS];
+INT64 x;
+INT64 y;
+UINT32 r = (UINT32)1 << decimLog2;
+UINT32 taps = 1;
+UINT32 seed = 12345 + order * 7 + decimLog2;
+UINT32 ok = 1;
+UINT32 ch;
+UINT32 m;
+UINT32 k;
+UINT32 j;
+INT32 v;
+char name[64];
+
+/* Random full scale samples, in the converter's own coding */
+for (ch = 0; ch < CHANNELS; ch++)
+    {
+    for (k = 0; k < MAX_SCANS; k++)
+        {
+        seed = seed * 1103515245u + 12345u;
+        v = (INT32)((seed >> 16) & ((1u << BITS) - 1));
+        adc.Value[ch][k] = isSigned ? v - (1 << (BITS - 1)) : v;
+        }
+    }
+
+/* Impulse response: boxcar of r taps convolved order times */
+h[0] = 1;
+for (j = 0; j < order; j++)
+    {
+    memset(t, 0, sizeof(t));
+    for (k = 0; k < taps; k++)
+        {
+        for (m = 0; m < r; m++)
+            {
+            t[k + m] += h[k];
+            }
+        }
+    taps += r - 1;
+    memcpy(h, t, sizeof(h));
+    }
+
+setup(&acq, &ring, frames, order, decimLog2, isSigned, latency);
+
+for (m = 0; m < FRAMES; m++)
+    {
+    for (k = 0; k < r; k++)
+        {
+        adc.Scan = m * r + k;
+        ok &= (SSP_ACQ_Scan(&acq) == SSP_WAIT_OK);
+        }
+
+    pFrame = SSP_ACQ_RingPeek(&ring);
+    ok &= (pFrame != NULL) && (pFrame->Seq == m);
+    if (pFrame == NULL)
+        {
+        break;
+        }
+
+    for (ch = 0; ch < CHANNELS; ch++)
+        {
+        /* Samples before the first scan are zero */
+        y = 0;
+        for (k = 0; (k < taps) && (k <= (m + 1) * r - 1); k++)
+            {
+            x = adc.Value[ch][(m + 1) * r - 1 - k];
+            y += h[k] * (isSigned ? x : x - (1 << (BITS - 1)));
+            }
+        ok &= (pFrame->Sample[ch] == (INT16)(y >> (order * decimLog2)));
+        }
+
+    SSP_ACQ_RingRelease(&ring);
+    }
+
+snprintf(name, sizeof(name), "CIC order %u, R=%u, %s, latency %u",
+         order, r, isSigned ? "signed" : "unsigned", latency);
+check(name, ok);
+}
+
+
+/*********************************************************************//**
+ * @brief       Abort one scan on a timeout and check the next frames
+ **********************************************************************/
+static void testAbort(UINT32 latency)
+{
+static const INT32 expect[CHANNELS] = { -1757, 2047, 0 };
+static SSP_ACQ_FRAME_Type frames[16];
+SSP_ACQ_RING_Type ring;
+SSP_ACQ_Type acq;
+const SSP_ACQ_FRAME_Type *pFrame;
+UINT32 ok = 1;
+UINT32 ch;
+UINT32 k;
+char name[64];
+
+for (ch = 0; ch < CHANNELS; ch++)
+    {
+    for (k = 0; k < MAX_SCANS; k++)
+        {
+        adc.Value[ch][k] = expect[ch];
+        }
+    }
+
+setup(&acq, &ring, frames, 1, 0, TRUE, latency);
+
+/* Far shorter than one word: the first wait of the scan times out */
+acq.Cfg.Timeout = 20;
+ok &= (SSP_ACQ_Scan(&acq) == SSP_WAIT_TIMEOUT);
+ok &= (SSP_ACQ_RingPeek(&ring) == NULL);
+acq.Cfg.Timeout = SSP_WAIT_FOREVER;
+
+for (k = 0; k < 4; k++)
+    {
+    ok &= (SSP_ACQ_Scan(&acq) == SSP_WAIT_OK);
+    pFrame = SSP_ACQ_RingPeek(&ring);
+    ok &= (pFrame != NULL);
+    if (pFrame == NULL)
+        {
+        break;
+        }
+    for (ch = 0; ch < CHANNELS; ch++)
+        {
+        ok &= (pFrame->Sample[ch] == expect[ch]);
+        }
+    SSP_ACQ_RingRelease(&ring);
+    }
+
+snprintf(name, sizeof(name), "channel order after a timeout, latency %u", latency);
+check(name, ok);
+}
+
+
+int main(void)
+{
+UINT32 order;
+UINT32 d;
+UINT32 s;
+
+for (order = 1; order <= SSP_ACQ_MAX_ORDER; order++)
+    {
+    for (d = 0; d <= 3; d += 3)
+        {
+        for (s = 0; s < 2; s++)
+            {
+            testCIC(order, d, (BOOLEAN)s, 0);
+            }
+        }
+    }
+testCIC(2, 2, TRUE, 1);
+
+testAbort(0);
+testAbort(1);
+
+return fail;
+}
@@ -0,0 +1,141 @@
+/*
+ * Chip select test on a modeled GRSPI core: a GPIO chip select must stay
+ * asserted until every word sent with SSP_BusSendData() has been shifted
+ * out, including words queued on a slow clock and words sent after the
+ * core went idle with LT still set from the previous one, and words sent
+ * while the receive queue overruns, with and without a clock gap. A deselect that
+ * exceeds the bus timeout must still release the chip select.
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include "common.h"
+#include "leon_ssp.h"
+#include "model.h"
+
+static MODEL_SSP_Type ssp;
+static LEON_GPIO_TypeDef gpio;
+static UINT32 shifted;
+static UINT32 shiftedDeselected;
+
+
+/*********************************************************************//**
+ * @brief       Device hook: count the words and those shifted while the
+ *              (active low) chip select on pin 0 was released
+ **********************************************************************/
+static UINT32 device(UINT32 tx, void *pArg)
+{
+(void)pArg;
+
+shifted++;
+if (gpio.IO_OUTPUT & 1)
+    {
+    shiftedDeselected++;
+    }
+
+return tx;
+}
+
+
+static int check(const char *name, UINT32 words)
+{
+int ok = (shifted == words) && (shiftedDeselected == 0) &&
+         !ssp.Shifting && (ssp.TxCount == 0) && (gpio.IO_OUTPUT & 1);
+
+printf("%-28s %s (%u/%u words, %u deselected)\n", name, ok ? "ok" : "FAIL",
+       (unsigned)shifted, (unsigned)words, (unsigned)shiftedDeselected);
+
+shifted = 0;
+shiftedDeselected = 0;
+while (SSP_GetStatus(&ssp.Regs, SSP_EVENT_NE) == SET)
+    {
+    SSP_ReceiveData(&ssp.Regs);
+    }
+
+return ok ? 0 : 1;
+}
+
+
+int main(void)
+{
+SSP_CFG_Type cfg;
+GPIO_SHADOW_Type port;
+SSP_CS_Type cs;
+SSP_BUS_Type bus;
+int fail = 0;
+UINT32 i;
+
+MODEL_Reset();
+MODEL_SSP_Init(&ssp, 8);
+MODEL_GPIO_Init(&gpio);
+ssp.pDevice = device;
+
+SSP_ConfigStructInit(&cfg);
+cfg.ClockRate = 100000;
+SSP_Init(&ssp.Regs, &cfg);
+SSP_Cmd(&ssp.Regs, ENABLE);
+
+GPIO_ShadowInit(&port, &gpio);
+SSP_CS_InitGPIO(&cs, &port, 0, SSP_CS_ACTIVE_LO);
+SSP_BusInit(&bus, &ssp.Regs);
+
+/* Full queue on a slow clock */
+SSP_CS_Select(&bus, &cs);
+for (i = 0; i < 8; i++)
+    {
+    SSP_BusSendData(&bus, i);
+    }
+fail |= (SSP_CS_Deselect(&bus) != SSP_WAIT_OK);
+fail |= check("full queue", 8);
+
+/* Next word sent after the previous one completed and set LT */
+SSP_CS_Select(&bus, &cs);
+SSP_BusSendData(&bus, 1);
+MODEL_Spend(100000);
+SSP_BusSendData(&bus, 2);
+fail |= (SSP_CS_Deselect(&bus) != SSP_WAIT_OK);
+fail |= check("word after idle", 2);
+
+/* Nothing sent: deselect must not wait for LT */
+SSP_CS_Select(&bus, &cs);
+fail |= (SSP_CS_Deselect(&bus) != SSP_WAIT_OK);
+fail |= check("no words", 0);
+
+/* Write-only transfer longer than the queues, RX never read: the receive
+   queue overruns while the chip select must stay asserted */
+SSP_CS_Select(&bus, &cs);
+for (i = 0; i < 20; i++)
+    {
+    while (SSP_GetStatus(&ssp.Regs, SSP_EVENT_NF) == RESET)
+        {
+        }
+    SSP_BusSendData(&bus, i);
+    }
+fail |= (SSP_CS_Deselect(&bus) != SSP_WAIT_OVERRUN);
+fail |= check("RX overrun", 20);
+
+/* Full queue with the longest clock gap: 8-bit words take 39 SCK, the
+   default deselect limit must account for it */
+ssp.Regs.MODE |= SSP_MODE_CG(31);
+SSP_CS_Select(&bus, &cs);
+for (i = 0; i < 8; i++)
+    {
+    SSP_BusSendData(&bus, i);
+    }
+fail |= (SSP_CS_Deselect(&bus) != SSP_WAIT_OK);
+fail |= check("clock gap", 8);
+ssp.Regs.MODE &= ~SSP_MODE_CG(SSP_MODE_CG_MASK);
+
+/* Bus timeout shorter than the queued words: the deselect gives up */
+SSP_CS_Select(&bus, &cs);
+for (i = 0; i < 4; i++)
+    {
+    SSP_BusSendData(&bus, i);
+    }
+bus.Timeout = 100;
+i = (SSP_CS_Deselect(&bus) == SSP_WAIT_TIMEOUT) && (gpio.IO_OUTPUT & 1);
+printf("%-28s %s\n", "bus timeout", i ? "ok" : "FAIL");
+fail |= !i;
+
+return fail;
+}
@@ -0,0 +1,119 @@
+/*
+ * Slave receiver test on a modeled GRSPI core fed by an external master that
+ * sends an incrementing word count, framed in 8 words starting with a
+ * multiple of 8 (the sync word). The receiver interrupt is held off long
+ * enough to overrun the receive queue; afterwards every frame handed out
+ * must be whole, and the first one must start on the first sync word sent
+ * after the receiver caught up.
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include "common.h"
+#include "leon_ssp_slave.h"
+#include "model.h"
+
+#define FRAME_WORDS     (8)
+#define PERIOD          (1000)      /* cycles between words of the master */
+#define QUANTUM         (50)
+#define STALL_WORDS     (21)        /* interrupt held off, in words       */
+
+static MODEL_SSP_Type ssp;
+static SSP_SLV_Type slv;
+static UINT32 buf[2][FRAME_WORDS];
+static int fail;
+
+
+static void check(const char *name, int ok)
+{
+printf("%-40s %s\n", name, ok ? "ok" : "FAIL");
+fail |= !ok;
+}
+
+
+/*********************************************************************//**
+ * @brief       Run the CPU, taking the SSP interrupt, and collect frames
+ * @param[in]   cycles      Time to run
+ * @param[out]  pFirst      Set to the first word of the first frame handed
+ *                          out, if still 0xFFFFFFFF
+ * @return      0 if every frame was whole and in sequence
+ **********************************************************************/
+static int run(UINT32 cycles, UINT32 *pFirst)
+{
+static UINT32 next = 0;
+SSP_SLV_FRAME_Type *pFrame;
+int bad = 0;
+UINT32 k;
+
+while (cycles >= QUANTUM)
+    {
+    MODEL_Spend(QUANTUM);
+    cycles -= QUANTUM;
+
+    if (MODEL_SSP_IrqPending(&ssp))
+        {
+        SSP_SLV_IRQHandler(&slv);
+        }
+
+    pFrame = SSP_SLV_GetFrame(&slv);
+    if (pFrame == NULL)
+        {
+        continue;
+        }
+
+    for (k = 0; k < FRAME_WORDS; k++)
+        {
+        bad |= (pFrame->pData[k] != pFrame->pData[0] + k);
+        }
+    bad |= (pFrame->pData[0] % FRAME_WORDS != 0) || (pFrame->Overruns != 0) ||
+           (pFrame->pData[0] < next);
+    next = pFrame->pData[0] + FRAME_WORDS;
+    if (*pFirst == 0xFFFFFFFF)
+        {
+        *pFirst = pFrame->pData[0];
+        }
+
+    SSP_SLV_ReleaseFrame(&slv, pFrame);
+    }
+
+return bad;
+}
+
+
+int main(void)
+{
+SSP_SLV_CFG_Type cfg = { FRAME_WORDS, FRAME_WORDS - 1, 0 };
+SSP_CFG_Type sspCfg;
+UINT32 first = 0xFFFFFFFF;
+UINT32 caughtUp;
+UINT32 overruns;
+
+MODEL_Reset();
+MODEL_SSP_Init(&ssp, 4);
+ssp.SlavePeriod = PERIOD;
+ssp.SlaveWord = 3;          /* start in the middle of a frame */
+
+SSP_ConfigStructInit(&sspCfg);
+sspCfg.Mode = SSP_SLAVE_MODE;
+sspCfg.Databit = SSP_DATABIT_16;
+SSP_Init(&ssp.Regs, &sspCfg);
+SSP_Cmd(&ssp.Regs, ENABLE);
+SSP_SLV_Init(&slv, &ssp.Regs, &cfg, buf[0], buf[1]);
+
+check("frames before the overrun", run(50 * PERIOD, &first) == 0);
+check("first frame on a sync word", first == 8);
+
+/* Interrupt held off in the middle of a frame */
+run(3 * PERIOD, &first);
+MODEL_Spend(STALL_WORDS * PERIOD);
+caughtUp = ssp.SlaveWord;
+overruns = slv.Overruns;
+
+first = 0xFFFFFFFF;
+check("frames after the overrun", run(50 * PERIOD, &first) == 0);
+check("overrun counted", slv.Overruns == overruns + 1);
+check("next sync word starts a frame",
+      first == (caughtUp + FRAME_WORDS - 1) / FRAME_WORDS * FRAME_WORDS);
+
+return fail;
+}
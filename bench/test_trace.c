@@ -0,0 +1,134 @@
+/*
+ * Trace round trip test: accesses recorded by leon_trace.c with cycle stamps
+ * from HAL.h, dumped to a file and decoded by tools/leon_trace_replay.c.
+ * The test writes the dump and the timeline and summary lines the replay
+ * tool must print for it:
+ *   test_trace trace.bin expected.txt
+ * The Makefile compares them with the output of leon_trace_replay -v.
+ * MODEL_Now() is defined here instead of linking model.c, which replaces the
+ * recorder.
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include "common.h"
+#include "leon_ssp.h"
+#include "leon_trace.h"
+#include "model.h"
+
+#define ACCESSES        (200)
+
+static UINT8 buf[8 * LEON_TRACE_BLOCK_SIZE];
+static LEON_SSP_TypeDef ssp;
+static LEON_GPIO_TypeDef gpio;
+static UINT32 now;
+static UINT32 last;
+static UINT32 count;
+static FILE *expected;
+
+
+/*********************************************************************//**
+ * @brief       Cycle counter seen by the recorder through SSP_CYCLE_COUNT()
+ **********************************************************************/
+UINT32 MODEL_Now(void)
+{
+return now;
+}
+
+void MODEL_Spend(UINT32 cycles)
+{
+now += cycles;
+}
+
+
+/*********************************************************************//**
+ * @brief       Print the timeline line of one access as the replay tool
+ **********************************************************************/
+static void expect(const char *dev, const char *reg, char dir, UINT32 value)
+{
+fprintf(expected, "%10u +%-7u  %s.%-12s %c 0x%08X\n", now,
+        (count++ == 0) ? 0 : now - last, dev, reg, dir, value);
+last = now;
+}
+
+
+static void dumpWrite(const UINT8 *pData, UINT32 len, void *pArg)
+{
+fwrite(pData, 1, len, (FILE *)pArg);
+}
+
+
+int main(int argc, char *argv[])
+{
+FILE *f;
+UINT32 lastMode = 0;
+UINT32 lastDir = 0;
+UINT32 redundant = 0;
+UINT32 value;
+UINT32 i;
+
+if (argc != 3)
+    {
+    fprintf(stderr, "usage: %s trace.bin expected.txt\n", argv[0]);
+    return 2;
+    }
+
+expected = fopen(argv[2], "w");
+f = fopen(argv[1], "wb");
+if ((expected == NULL) || (f == NULL))
+    {
+    return 1;
+    }
+
+LEON_TraceInit(buf, sizeof(buf));
+LEON_TraceAttach(&ssp, sizeof(ssp), LEON_TRACE_KIND_SSP);
+LEON_TraceAttach(&gpio, sizeof(gpio), LEON_TRACE_KIND_GPIO);
+
+/* Stamps from 1 to 2^24 cycles apart, values across the full range so
+   that the varints take one to five bytes, over more than one block.
+   Repeated MODE reads and IO_DIR writes of a known value are redundant. */
+now = 1000;
+for (i = 0; i < ACCESSES; i++)
+    {
+    value = (i * 0x9E3779B9u) >> (i % 29);
+    if (i & 1)
+        {
+        LEON_WR(gpio.IO_DIR, value);
+        expect("GPIO1", "IO_DIR", 'W', value);
+        redundant += (i > 1) && (value == lastDir);
+        lastDir = value;
+        }
+    else
+        {
+        ssp.MODE = value;
+        LEON_RD(ssp.MODE);
+        expect("SSP0", "MODE", 'R', value);
+        redundant += (i > 0) && (value == lastMode);
+        lastMode = value;
+        }
+    now += 1u << (i % 25);
+    }
+
+/* Read-modify-write of IO_OUTPUT, then a read of MASK separated from its
+   write by another access, which is not one */
+LEON_WR(gpio.IO_OUTPUT, LEON_RD(gpio.IO_OUTPUT) | 1);
+expect("GPIO1", "IO_OUTPUT", 'R', 0);
+expect("GPIO1", "IO_OUTPUT", 'W', 1);
+now += 10;
+value = LEON_RD(ssp.MASK);
+expect("SSP0", "MASK", 'R', value);
+now += 10;
+LEON_WR(ssp.CMD, SSP_CMD_LST);
+expect("SSP0", "CMD", 'W', SSP_CMD_LST);
+now += 10;
+LEON_WR(ssp.MASK, value | SSP_EVENT_LT);
+expect("SSP0", "MASK", 'W', value | SSP_EVENT_LT);
+
+LEON_TraceDump(dumpWrite, f);
+fclose(f);
+
+fprintf(expected, "redundant accesses %u, read-modify-write 1\n", (unsigned)redundant);
+fclose(expected);
+
+return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * UIO backend test on a host: a memfd stands for the device memory and is
+ * opened through /proc/self/fd with UIO_OpenMem(), then driven with the
+ * unchanged GPIO and SSP drivers. A socketpair stands for a UIO device whose
+ * interrupt fires for other sources than the awaited event, which must not
+ * extend the timeout of UIO_SSP_WaitEvent().
+ * Built without LEON_TRACE so that the drivers access the mapping directly.
+ */
+
+#define _GNU_SOURCE
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "common.h"
+#include "leon_uio.h"
+
+#define WINDOW_BASE     (0x1300)    /* not page aligned */
+#define WINDOW_SIZE     (0x40)
+#define FILE_SIZE       (0x10000)
+#define TIMEOUT_MS      (100)
+#define IRQ_PERIOD_US   (10000)
+
+static int fail;
+
+
+static void check(const char *name, int ok)
+{
+printf("%-40s %s\n", name, ok ? "ok" : "FAIL");
+fail |= !ok;
+}
+
+
+/*********************************************************************//**
+ * @brief       Read a register of the window from the backing file
+ **********************************************************************/
+static UINT32 backing(int fd, UINT32 offset)
+{
+UINT32 value = 0;
+
+if (pread(fd, &value, sizeof(value), WINDOW_BASE + offset) != sizeof(value))
+    {
+    return 0xDEADBEEF;
+    }
+
+return value;
+}
+
+
+static void testMem(void)
+{
+char path[64];
+UIO_DEV_Type dev;
+LEON_GPIO_TypeDef *pGPIO;
+LEON_SSP_TypeDef *SSPx;
+UINT32 event = SSP_EVENT_NE;
+int fd;
+
+fd = memfd_create("leon_regs", 0);
+if ((fd < 0) || (ftruncate(fd, FILE_SIZE) != 0))
+    {
+    check("memfd", 0);
+    return;
+    }
+snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+
+check("UIO_OpenMem", UIO_OpenMem(&dev, path, WINDOW_BASE, WINDOW_SIZE) == SUCCESS);
+check("window offset inside the page",
+      (UINT8 *)dev.pRegs - (UINT8 *)dev.pMap == (WINDOW_BASE & 0xFFF));
+
+pGPIO = UIO_GetGPIO(&dev);
+GPIO_SetDir(pGPIO, 0x0F, GPIO_DIRECTION_OUTPUT);
+GPIO_SetValue(pGPIO, 0x05);
+GPIO_ClearValue(pGPIO, 0x04);
+check("GPIO direction reaches the file", backing(fd, 0x08) == 0x0F);
+check("GPIO output reaches the file", backing(fd, 0x04) == 0x01);
+
+SSPx = UIO_GetSSP(&dev);
+SSP_SendData(SSPx, 0x1234);
+check("SSP TX reaches the file", backing(fd, 0x30) == 0x1234);
+
+if (pwrite(fd, &event, sizeof(event), WINDOW_BASE + 0x24) != sizeof(event))
+    {
+    check("event write", 0);
+    }
+check("SSP event from the file", SSP_GetStatus(SSPx, SSP_EVENT_NE) == SET);
+
+/* No interrupt on a /dev/mem window: only an already set event succeeds */
+check("WaitEvent with the event already set",
+      UIO_SSP_WaitEvent(&dev, SSPx, SSP_EVENT_NE, TIMEOUT_MS) == SUCCESS);
+check("WaitEvent without interrupt fails",
+      UIO_SSP_WaitEvent(&dev, SSPx, SSP_EVENT_LT, TIMEOUT_MS) == ERROR);
+check("MASK restored", backing(fd, 0x28) == 0);
+
+UIO_Close(&dev);
+close(fd);
+}
+
+
+static void testTimeout(void)
+{
+static LEON_SSP_TypeDef regs;
+UIO_DEV_Type dev;
+struct timespec t0;
+struct timespec t1;
+UINT32 count = 1;
+Status ret;
+long ms;
+pid_t pid;
+int sv[2];
+
+if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    {
+    check("socketpair", 0);
+    return;
+    }
+
+memset(&dev, 0, sizeof(dev));
+dev.Fd = sv[0];
+dev.IsUIO = TRUE;
+dev.pRegs = (volatile UINT32 *)&regs;
+
+pid = fork();
+if (pid == 0)
+    {
+    /* Interrupts of another source, until killed */
+    close(sv[0]);
+    while (write(sv[1], &count, sizeof(count)) == sizeof(count))
+        {
+        count++;
+        usleep(IRQ_PERIOD_US);
+        }
+    _exit(0);
+    }
+
+clock_gettime(CLOCK_MONOTONIC, &t0);
+ret = UIO_SSP_WaitEvent(&dev, &regs, SSP_EVENT_LT, TIMEOUT_MS);
+clock_gettime(CLOCK_MONOTONIC, &t1);
+
+kill(pid, SIGKILL);
+waitpid(pid, NULL, 0);
+close(sv[0]);
+close(sv[1]);
+
+ms = (t1.tv_sec - t0.tv_sec) * 1000L + (t1.tv_nsec - t0.tv_nsec) / 1000000L;
+printf("%-40s %ld ms\n", "WaitEvent under foreign interrupts", ms);
+check("WaitEvent times out", ret == ERROR);
+check("timeout not extended by interrupts", (ms >= TIMEOUT_MS) && (ms < 2 * TIMEOUT_MS));
+check("MASK restored", regs.MASK == 0);
+}
+
+
+int main(void)
+{
+testMem();
+testTimeout();
+
+return fail;
+}
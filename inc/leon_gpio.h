@@ -1,6 +1,7 @@
 #ifndef __leon_gpio_h
 #define __leon_gpio_h
 
+#include "leon_trace.h"
 
 /*------------- General Purpose Input/Output (GPIO) --------------------------*/
 typedef struct
@@ -28,6 +29,33 @@ typedef struct
 #define GPIO_DIRECTION_OUTPUT       (1)
 
 
+/** @brief GPIO output shadow. Keeps a copy of IO_OUTPUT so that pins can be
+ * changed with a single store instead of a read-modify-write over APB. Once a
+ * shadow is attached to a port, all output changes on that port must go
+ * through the shadow functions. */
+typedef struct {
+    LEON_GPIO_TypeDef *pGPIO;   /** GPIO port the shadow belongs to          */
+    UINT32 Output;              /** Last value written to IO_OUTPUT           */
+} GPIO_SHADOW_Type;
+
+
+/** Maximum number of ports in a bulk image (128 bits) */
+#define GPIO_BULK_MAX_PORTS         (4)
+
+/** @brief Set of GPIO ports sampled and updated together. The port list
+ * is checked once by GPIO_BulkInit() so the bulk accesses need no checks. */
+typedef struct {
+    LEON_GPIO_TypeDef *pPort[GPIO_BULK_MAX_PORTS]; /** Ports, image order   */
+    UINT32 NumPorts;                               /** From 1 to 4          */
+} GPIO_BULK_Type;
+
+/** @brief Packed image of a port set, word n holds port n */
+typedef struct {
+    UINT32 Word[GPIO_BULK_MAX_PORTS];
+} GPIO_IMAGE_Type;
+
+
+
 
 /* GPIO Init/DeInit functions --------------------------------------------------*/
 void GPIO_Init(void);
@@ -39,5 +67,87 @@ void GPIO_OutputValue(LEON_GPIO_TypeDef *pGPIO, UINT32 bitMask, UINT8 value);
 
 UINT32 GPIO_ReadValue(LEON_GPIO_TypeDef *pGPIO);
 
+/* GPIO output shadow functions ------------------------------------------------*/
+void GPIO_ShadowInit(GPIO_SHADOW_Type *pShadow, LEON_GPIO_TypeDef *pGPIO);
+void GPIO_ShadowSetValue(GPIO_SHADOW_Type *pShadow, UINT32 bitValue);
+void GPIO_ShadowClearValue(GPIO_SHADOW_Type *pShadow, UINT32 bitValue);
+
+/* GPIO bulk functions --------------------------------------------------------*/
+BOOLEAN GPIO_BulkInit(GPIO_BULK_Type *pBulk, LEON_GPIO_TypeDef * const *ppPort, UINT32 numPorts);
+void GPIO_BulkRead(const GPIO_BULK_Type *pBulk, GPIO_IMAGE_Type *pImage);
+void GPIO_BulkWrite(const GPIO_BULK_Type *pBulk, const GPIO_IMAGE_Type *pImage);
+
+
+/*********************************************************************//**
+ * @brief       Inline version of GPIO_BulkRead(). IO_DATA of all ports is
+ *              read back-to-back before the image is stored.
+ * @param[in]   pBulk       Port set
+ * @param[out]  pImage      Input image
+ * @return      None
+ **********************************************************************/
+static inline void GPIO_BulkReadFast(const GPIO_BULK_Type *pBulk, GPIO_IMAGE_Type *pImage)
+{
+LEON_GPIO_TypeDef * const *p = pBulk->pPort;
+UINT32 d0, d1, d2, d3;
+
+switch (pBulk->NumPorts)
+    {
+    case 4:
+        d0 = LEON_RD(p[0]->IO_DATA);
+        d1 = LEON_RD(p[1]->IO_DATA);
+        d2 = LEON_RD(p[2]->IO_DATA);
+        d3 = LEON_RD(p[3]->IO_DATA);
+        pImage->Word[3] = d3;
+        break;
+    case 3:
+        d0 = LEON_RD(p[0]->IO_DATA);
+        d1 = LEON_RD(p[1]->IO_DATA);
+        d2 = LEON_RD(p[2]->IO_DATA);
+        break;
+    case 2:
+        d0 = LEON_RD(p[0]->IO_DATA);
+        d1 = LEON_RD(p[1]->IO_DATA);
+        pImage->Word[0] = d0;
+        pImage->Word[1] = d1;
+        return;
+    default:
+        pImage->Word[0] = LEON_RD(p[0]->IO_DATA);
+        return;
+    }
+
+pImage->Word[0] = d0;
+pImage->Word[1] = d1;
+pImage->Word[2] = d2;
+}
+
+
+/*********************************************************************//**
+ * @brief       Inline version of GPIO_BulkWrite(). IO_OUTPUT of every port
+ *              is written with one store, without reading it first.
+ * @param[in]   pBulk       Port set
+ * @param[in]   pImage      Output image
+ * @return      None
+ **********************************************************************/
+static inline void GPIO_BulkWriteFast(const GPIO_BULK_Type *pBulk, const GPIO_IMAGE_Type *pImage)
+{
+LEON_GPIO_TypeDef * const *p = pBulk->pPort;
+
+switch (pBulk->NumPorts)
+    {
+    case 4:
+        LEON_WR(p[3]->IO_OUTPUT, pImage->Word[3]);
+        /* fall through */
+    case 3:
+        LEON_WR(p[2]->IO_OUTPUT, pImage->Word[2]);
+        /* fall through */
+    case 2:
+        LEON_WR(p[1]->IO_OUTPUT, pImage->Word[1]);
+        /* fall through */
+    default:
+        LEON_WR(p[0]->IO_OUTPUT, pImage->Word[0]);
+        break;
+    }
+}
+
 
 #endif /* __leon_gpio_h */
@@ -1,6 +1,7 @@
 #ifndef __leon_ssp_h
 #define __leon_ssp_h
 
+#include "leon_gpio.h"
 
 /*------------- Synchronous Serial Communication (SSP) -----------------------*/
 typedef struct
@@ -270,6 +271,10 @@ automatically by the core when the queue is full, writes have no effect. */
 #define SSP_EVENT_R0_MASK    (0xFF)
 #define SSP_EVENT_R0(n)      ((UINT32)((n&SSP_EVENT_R0_MASK)<<0))
 
+/* Error events (OV, UN, MME) and all bits that are cleared by writing '1'. */
+#define SSP_EVENT_ERRORS     (SSP_EVENT_OV | SSP_EVENT_UN | SSP_EVENT_MME)
+#define SSP_EVENT_W1C        (SSP_EVENT_LT | SSP_EVENT_ERRORS)
+
 
 
 /*********************************************************************//**
@@ -351,6 +356,9 @@ cleared when the Event register bit has been set and is always read as zero. */
  /*********************************************************************//**
  * Macro defines for Slave select register (optional)
  **********************************************************************/
+/* Slave select (SLVSEL) - Bit n drives slave select line n. The lines are active low: writing '0' to a
+bit selects the corresponding slave. Only SSSZ bits (see Capability register) are implemented. */
+#define SSP_SLAVESEL_SS(n)    ((UINT32)(1<<(n)))
 
  /*********************************************************************//**
  * Macro defines for Automatic slave select register
@@ -436,9 +444,68 @@ typedef struct {
 /** SSP status SSP Busy bit */
 #define SSP_STAT_BUSY           SSP_EVENT_TIP
 
+/** Compiler barrier ordering buffer stores before the flag or index that
+ * hands the buffer to another context (thread or ISR), and the flag read
+ * before the buffer reads. A single LEON3 core needs no hardware barrier,
+ * other targets may define SSP_BARRIER() on the compiler command line. */
+#ifndef SSP_BARRIER
+#define SSP_BARRIER()           __asm__ __volatile__("" ::: "memory")
+#endif
+
 
 typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
 typedef enum { RESET = 0, SET = !RESET } FlagStatus, IntStatus, SetState;
+typedef enum { ERROR = 0, SUCCESS = !ERROR } Status;
+
+
+/** Chip select type */
+#define SSP_CS_NATIVE           ((UINT32)(0))   /*!< Line of the SLAVESEL register */
+#define SSP_CS_GPIO             ((UINT32)(1))   /*!< Pin of a GRGPIO port          */
+
+/** Chip select polarity, only used for SSP_CS_GPIO (SLAVESEL lines are active low) */
+#define SSP_CS_ACTIVE_LO        ((UINT32)(0))
+#define SSP_CS_ACTIVE_HI        ((UINT32)(1))
+
+/** Timeout value that disables the timeout of the wait functions */
+#define SSP_WAIT_FOREVER        ((UINT32)(0xFFFFFFFF))
+
+
+/** @brief SSP wait result */
+typedef enum {
+    SSP_WAIT_OK = 0,        /*!< Wait condition met                          */
+    SSP_WAIT_TIMEOUT,       /*!< Timeout expired before the condition was met */
+    SSP_WAIT_OVERRUN,       /*!< OV: receive data has been discarded          */
+    SSP_WAIT_UNDERRUN,      /*!< UN: transmit queue was empty in slave mode   */
+    SSP_WAIT_MME            /*!< MME: multiple-master error, core disabled    */
+} SSP_WAIT_Status;
+
+
+/** @brief SSP chip select descriptor. Describes either a native slave select
+ * line or a GPIO pin used as slave select beyond the SSSZ limit. */
+typedef struct {
+    UINT32 Type;               /** Chip select type, should be:
+                               - SSP_CS_NATIVE: SLAVESEL line
+                               - SSP_CS_GPIO: GPIO pin                  */
+    UINT32 Mask;               /** SLAVESEL bit or GPIO pin bit         */
+    GPIO_SHADOW_Type *pPort;   /** Output shadow of the GPIO port,
+                               only used for SSP_CS_GPIO                */
+    UINT32 Polarity;           /** Active level, should be:
+                               - SSP_CS_ACTIVE_LO: active low
+                               - SSP_CS_ACTIVE_HI: active high          */
+} SSP_CS_Type;
+
+
+/** @brief SSP bus chip select state. All chip select changes on a bus go
+ * through this structure so that the currently selected device is known. */
+typedef struct {
+    LEON_SSP_TypeDef *SSPx;    /** SSP peripheral driving the bus        */
+    const SSP_CS_Type *Active; /** Currently asserted chip select or NULL */
+    UINT32 SlaveSel;           /** Shadow of the SLAVESEL register        */
+    BOOLEAN Sent;              /** Words sent with SSP_BusSendData() since
+                               the last deselect                          */
+    UINT32 Timeout;            /** Limit of the deselect waits in system
+                               clock cycles, 0: time of a full queue      */
+} SSP_BUS_Type;
 
 /* SSP Init/DeInit functions --------------------------------------------------*/
 void SSP_Init(LEON_SSP_TypeDef *SSPx, SSP_CFG_Type *SSP_ConfigStruct);
@@ -452,12 +519,27 @@ void SSP_Cmd(LEON_SSP_TypeDef* SSPx, FunctionalState NewState);
 
 /* SSP get information functions ----------------------------------------------*/
 FlagStatus SSP_GetStatus(LEON_SSP_TypeDef* SSPx, UINT32 FlagType);
+UINT32 SSP_ReadEvents(LEON_SSP_TypeDef* SSPx);
+
+/* SSP wait functions ---------------------------------------------------------*/
+SSP_WAIT_Status SSP_WaitEvent(LEON_SSP_TypeDef* SSPx, UINT32 events,
+                              UINT32 timeout, UINT32 *pEvent);
+SSP_WAIT_Status SSP_WaitIdle(LEON_SSP_TypeDef* SSPx, UINT32 timeout);
+UINT32 SSP_GetWordCycles(LEON_SSP_TypeDef* SSPx);
 
 
 /* SSP transfer data functions ------------------------------------------------*/
 void SSP_SendData(LEON_SSP_TypeDef* SSPx, UINT32 Data);
 UINT32 SSP_ReceiveData(LEON_SSP_TypeDef* SSPx);
 
+/* SSP chip select functions --------------------------------------------------*/
+void SSP_BusInit(SSP_BUS_Type *pBus, LEON_SSP_TypeDef *SSPx);
+Status SSP_CS_InitNative(SSP_CS_Type *pCS, LEON_SSP_TypeDef *SSPx, UINT32 line);
+void SSP_CS_InitGPIO(SSP_CS_Type *pCS, GPIO_SHADOW_Type *pPort, UINT32 pin, UINT32 polarity);
+SSP_WAIT_Status SSP_CS_Select(SSP_BUS_Type *pBus, const SSP_CS_Type *pCS);
+SSP_WAIT_Status SSP_CS_Deselect(SSP_BUS_Type *pBus);
+void SSP_BusSendData(SSP_BUS_Type *pBus, UINT32 Data);
+
 
 
 #endif /* __leon_ssp_h */
@@ -0,0 +1,89 @@
+#ifndef __leon_ssp_acq_h
+#define __leon_ssp_acq_h
+
+#include "leon_ssp.h"
+
+
+/*------------- Decimating ADC acquisition on SSP ----------------------------*/
+/* NOTE:
+* One scan sends the command word of every channel back-to-back, keeping the
+* transmit queue filled up to the FIFO depth, and unpacks each received word
+* straight into a CIC decimator (order 1 is a moving average). Every 2^DecimLog2
+* scans one frame of decimated samples is put into a single-producer /
+* single-consumer ring that the consumer reads in place.
+*/
+
+
+/*********************************************************************//**
+ * Macro defines for acquisition limits
+ **********************************************************************/
+#define SSP_ACQ_MAX_CHANNELS    (16)
+#define SSP_ACQ_MAX_ORDER       (3)
+
+
+/** @brief Acquisition configuration structure */
+typedef struct {
+    UINT32 NumChannels;        /** Channels per scan,
+                               from 1 to SSP_ACQ_MAX_CHANNELS             */
+    const UINT32 *pCommand;    /** Command word sent for each channel     */
+    UINT32 Latency;            /** Words between a command and its result:
+                               - 0: result in the same word
+                               - 1: pipelined converter                   */
+    UINT32 Shift;              /** Position of the sample LSB in RX words */
+    UINT32 Bits;               /** Sample width, from 4 to 16             */
+    BOOLEAN Signed;            /** Samples are two's complement. Unsigned
+                               samples are centered around zero           */
+    UINT32 Order;              /** CIC order, from 1 to SSP_ACQ_MAX_ORDER,
+                               1 is a moving average                      */
+    UINT32 DecimLog2;          /** Decimation ratio is 2^DecimLog2        */
+    UINT32 Timeout;            /** Timeout per received word, in system
+                               clock cycles, or SSP_WAIT_FOREVER          */
+} SSP_ACQ_CFG_Type;
+
+
+/** @brief Decimated frame */
+typedef struct {
+    UINT32 Seq;                            /** Frame sequence number     */
+    INT16 Sample[SSP_ACQ_MAX_CHANNELS];    /** One sample per channel    */
+} SSP_ACQ_FRAME_Type;
+
+
+/** @brief Single-producer/single-consumer frame ring */
+typedef struct {
+    SSP_ACQ_FRAME_Type *pFrames;   /** Frame storage                      */
+    UINT32 SizeMask;               /** Number of frames - 1 (power of 2)  */
+    volatile UINT32 Head;          /** Frames produced, producer only     */
+    volatile UINT32 Tail;          /** Frames consumed, consumer only     */
+    UINT32 Dropped;                /** Frames lost on a full ring         */
+} SSP_ACQ_RING_Type;
+
+
+/** @brief Acquisition pipeline state */
+typedef struct {
+    LEON_SSP_TypeDef *SSPx;        /** SSP peripheral the ADC is on       */
+    SSP_ACQ_CFG_Type Cfg;          /** Copy of the configuration          */
+    SSP_ACQ_RING_Type *pRing;      /** Output ring                        */
+    UINT32 Depth;                  /** Words the queues hold (FDEPTH+1)   */
+    UINT32 Mask;                   /** Sample mask after shift            */
+    UINT32 Offset;                 /** Mid-scale value (sign bit)         */
+    UINT32 Flip;                   /** Offset for signed samples, else 0  */
+    UINT32 Phase;                  /** Scans accumulated in this frame    */
+    UINT32 Seq;                    /** Next frame sequence number         */
+    UINT32 State[SSP_ACQ_MAX_CHANNELS][2 * SSP_ACQ_MAX_ORDER];
+                                   /** Integrators then comb delays,
+                                   per channel                            */
+} SSP_ACQ_Type;
+
+
+/* Acquisition ring functions -------------------------------------------------*/
+Status SSP_ACQ_RingInit(SSP_ACQ_RING_Type *pRing, SSP_ACQ_FRAME_Type *pFrames, UINT32 count);
+const SSP_ACQ_FRAME_Type *SSP_ACQ_RingPeek(SSP_ACQ_RING_Type *pRing);
+void SSP_ACQ_RingRelease(SSP_ACQ_RING_Type *pRing);
+
+/* Acquisition functions ------------------------------------------------------*/
+Status SSP_ACQ_Init(SSP_ACQ_Type *pAcq, LEON_SSP_TypeDef *SSPx,
+                    const SSP_ACQ_CFG_Type *pCfg, SSP_ACQ_RING_Type *pRing);
+SSP_WAIT_Status SSP_ACQ_Scan(SSP_ACQ_Type *pAcq);
+
+
+#endif /* __leon_ssp_acq_h */
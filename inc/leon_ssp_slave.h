@@ -0,0 +1,75 @@
+#ifndef __leon_ssp_slave_h
+#define __leon_ssp_slave_h
+
+#include "leon_ssp.h"
+
+
+/*------------- Double-buffered SSP slave receiver ----------------------------*/
+/* NOTE:
+* SSP_SLV_IRQHandler() must be called from the SSP interrupt. It drains the
+* receive queue into one of two frame buffers. A completed frame is handed to
+* the application by pointer (SSP_SLV_GetFrame) while the other buffer fills,
+* and is returned with SSP_SLV_ReleaseFrame(). If the application still holds
+* a frame when the next one completes, the new frame is dropped and counted.
+* The NE interrupt fires on the 0 to 1 transition of NE only, so the handler
+* always drains the queue until it is empty.
+* On an overrun with a sync word configured, the frame being received and
+* the words queued before the loss are dropped and the receiver waits for
+* the next sync word. Without a sync word the frame is kept and flagged.
+*/
+
+
+/*********************************************************************//**
+ * Macro defines for the slave receiver
+ **********************************************************************/
+#define SSP_SLV_NUM_BUFFERS     (2)
+
+
+/** @brief Slave receiver configuration structure */
+typedef struct {
+    UINT32 FrameLen;           /** Words per frame                         */
+    UINT32 SyncMask;           /** Bits of the first frame word compared
+                               with SyncWord, 0 if frames have no sync
+                               word                                        */
+    UINT32 SyncWord;           /** Value of the first frame word           */
+} SSP_SLV_CFG_Type;
+
+
+/** @brief Received frame */
+typedef struct {
+    UINT32 *pData;             /** Frame words (application buffer)        */
+    UINT32 Seq;                /** Frame sequence number                   */
+    UINT32 Overruns;           /** OV events while the frame was received  */
+} SSP_SLV_FRAME_Type;
+
+
+/** @brief Slave receiver state */
+typedef struct {
+    LEON_SSP_TypeDef *SSPx;            /** SSP peripheral in slave mode    */
+    SSP_SLV_CFG_Type Cfg;              /** Copy of the configuration       */
+    UINT32 Depth;                      /** Words the queue holds (FDEPTH+1) */
+    SSP_SLV_FRAME_Type Frame[SSP_SLV_NUM_BUFFERS];
+    volatile UINT32 Full[SSP_SLV_NUM_BUFFERS];
+                                       /** Frame owned by the application  */
+    UINT32 Fill;                       /** Buffer being filled             */
+    UINT32 Pos;                        /** Words in the buffer being filled */
+    BOOLEAN Synced;                    /** Sync word found                 */
+    UINT32 Seq;                        /** Next frame sequence number      */
+    UINT32 Overruns;                   /** Total OV events                 */
+    UINT32 Dropped;                    /** Frames dropped, both buffers in
+                                       use                                 */
+    UINT32 Resyncs;                    /** Frames lost looking for sync,
+                                       after a bad sync word or an OV      */
+} SSP_SLV_Type;
+
+
+/* Slave receiver functions ---------------------------------------------------*/
+Status SSP_SLV_Init(SSP_SLV_Type *pSlv, LEON_SSP_TypeDef *SSPx, const SSP_SLV_CFG_Type *pCfg,
+                    UINT32 *pBuf0, UINT32 *pBuf1);
+void SSP_SLV_Stop(SSP_SLV_Type *pSlv);
+void SSP_SLV_IRQHandler(SSP_SLV_Type *pSlv);
+SSP_SLV_FRAME_Type *SSP_SLV_GetFrame(SSP_SLV_Type *pSlv);
+void SSP_SLV_ReleaseFrame(SSP_SLV_Type *pSlv, SSP_SLV_FRAME_Type *pFrame);
+
+
+#endif /* __leon_ssp_slave_h */
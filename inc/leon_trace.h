@@ -0,0 +1,85 @@
+#ifndef __leon_trace_h
+#define __leon_trace_h
+
+
+/*------------- Register access tracing --------------------------------------*/
+/* NOTE:
+* The drivers access peripheral registers through LEON_RD()/LEON_WR(). When
+* LEON_TRACE is not defined these expand to plain volatile accesses, so a
+* build without tracing is unchanged. When LEON_TRACE is defined every access
+* to an attached register block is recorded (register offset, value and cycle
+* stamp) into a ring of fixed size blocks. Each block starts with a key frame,
+* so the oldest block can be overwritten while the rest stays decodable.
+* LEON_TraceDump() writes the trace in the format below; tools/leon_trace_replay.c
+* reads it back on a Linux host.
+*
+* Dump format (all fields little endian):
+*   header:  "LTRC", UINT8 version, UINT8 device count, UINT16 block size,
+*            UINT32 block count
+*   device:  UINT8 kind, UINT32 base address, UINT32 size       (per device)
+*   block:   UINT16 bytes used, UINT32 cycles, UINT32 value     (key frame)
+*            records..., unused bytes up to the block size
+*   record:  UINT16 tag, varint cycle delta, varint value XOR previous value
+*            tag bit 15 = write, bits 14-11 = device, bits 10-0 = word offset
+*/
+
+
+/*********************************************************************//**
+ * Macro defines for register access
+ **********************************************************************/
+#ifdef LEON_TRACE
+#define LEON_RD(reg)            LEON_TraceRead(&(reg))
+#define LEON_WR(reg, val)       LEON_TraceWrite(&(reg), (UINT32)(val))
+#else
+#define LEON_RD(reg)            (reg)
+#define LEON_WR(reg, val)       ((reg) = (val))
+#endif
+
+
+/*********************************************************************//**
+ * Macro defines for the trace format
+ **********************************************************************/
+#define LEON_TRACE_VERSION      (1)
+#define LEON_TRACE_MAX_DEVICES  (16)
+#define LEON_TRACE_NO_DEVICE    ((UINT32)(0xFFFFFFFF))
+
+/** Block size in bytes, and the size of a block key frame */
+#ifndef LEON_TRACE_BLOCK_SIZE
+#define LEON_TRACE_BLOCK_SIZE   (256)
+#endif
+#define LEON_TRACE_KEY_SIZE     (10)
+
+/** Largest record: tag + two 5 byte varints */
+#define LEON_TRACE_RECORD_MAX   (12)
+
+/** Record tag fields */
+#define LEON_TRACE_TAG_WRITE    ((UINT32)(1<<15))
+#define LEON_TRACE_TAG_DEV(n)   ((UINT32)(((n)&0xF)<<11))
+#define LEON_TRACE_TAG_OFF_MASK (0x7FF)
+
+/** Kind of traced register block */
+#define LEON_TRACE_KIND_SSP     (0)
+#define LEON_TRACE_KIND_GPIO    (1)
+#define LEON_TRACE_KIND_OTHER   (2)
+
+/* Recorder hooks, resolved in leon_trace.c after HAL.h so that HAL.h may
+ * define them:
+ * - LEON_TRACE_CYCLES(): cycle stamp source, defaults to SSP_CYCLE_COUNT()
+ *   when HAL.h provides it, otherwise stamps only count accesses
+ * - LEON_TRACE_LOCK()/LEON_TRACE_UNLOCK(): critical section around a
+ *   record, e.g. raising the processor interrupt level. There is no
+ *   default: drivers such as SSP_SLV_IRQHandler() access registers from
+ *   interrupt level, so a traced build fails unless HAL.h defines both,
+ *   empty ones being only safe without register accesses from interrupts */
+
+
+/* Trace functions ------------------------------------------------------------*/
+void LEON_TraceInit(UINT8 *pBuf, UINT32 size);
+UINT32 LEON_TraceAttach(const volatile void *base, UINT32 size, UINT32 kind);
+void LEON_TraceEnable(UINT32 enable);
+UINT32 LEON_TraceRead(const volatile UINT32 *pReg);
+void LEON_TraceWrite(volatile UINT32 *pReg, UINT32 value);
+UINT32 LEON_TraceDump(void (*pWrite)(const UINT8 *pData, UINT32 len, void *pArg), void *pArg);
+
+
+#endif /* __leon_trace_h */
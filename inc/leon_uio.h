@@ -0,0 +1,58 @@
+#ifndef __leon_uio_h
+#define __leon_uio_h
+
+#include "leon_gpio.h"
+#include "leon_ssp.h"
+
+
+/*------------- Userspace register access (Linux UIO / /dev/mem) -------------*/
+/* NOTE:
+* This backend is only meant for LEON/GR7xx targets running Linux. Registers
+* are accessed through a shared mapping of the device, so the drivers in
+* leon_ssp.c and leon_gpio.c work unchanged on the returned pointers and no
+* system call is made per register access. Interrupts are only available when
+* the window was opened through a UIO device.
+* UIO_OpenMem() accepts any file that can be mapped, so the drivers can be
+* exercised on a host by mapping a regular file or a memfd as a fake register
+* window.
+*/
+
+
+/*********************************************************************//**
+ * Macro defines for UIO interrupt control
+ **********************************************************************/
+/** Value written to a UIO device to (re-)enable its interrupt */
+#define UIO_IRQ_ENABLE          ((UINT32)(1))
+
+/** Infinite timeout for UIO_WaitIRQ() */
+#define UIO_WAIT_FOREVER        (-1)
+
+
+/** @brief Mapped register window */
+typedef struct {
+    int Fd;                    /** File descriptor of the mapped device   */
+    void *pMap;                /** Start of the page aligned mapping      */
+    UINT32 MapSize;            /** Length of the mapping in bytes         */
+    volatile UINT32 *pRegs;    /** First register of the window           */
+    BOOLEAN IsUIO;             /** Interrupts can be waited for by read() */
+} UIO_DEV_Type;
+
+
+/* UIO open/close functions ---------------------------------------------------*/
+Status UIO_OpenUIO(UIO_DEV_Type *pDev, const char *path, UINT32 mapIndex,
+                   UINT32 offset, UINT32 size);
+Status UIO_OpenMem(UIO_DEV_Type *pDev, const char *path, UINT32 base, UINT32 size);
+void UIO_Close(UIO_DEV_Type *pDev);
+
+/* UIO register access functions ----------------------------------------------*/
+LEON_SSP_TypeDef *UIO_GetSSP(UIO_DEV_Type *pDev);
+LEON_GPIO_TypeDef *UIO_GetGPIO(UIO_DEV_Type *pDev);
+
+/* UIO interrupt functions ----------------------------------------------------*/
+Status UIO_EnableIRQ(UIO_DEV_Type *pDev);
+INT32 UIO_WaitIRQ(UIO_DEV_Type *pDev, INT32 timeout_ms);
+Status UIO_SSP_WaitEvent(UIO_DEV_Type *pDev, LEON_SSP_TypeDef *SSPx,
+                         UINT32 events, INT32 timeout_ms);
+
+
+#endif /* __leon_uio_h */
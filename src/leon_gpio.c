@@ -59,7 +59,8 @@ void GPIO_SetDir(LEON_GPIO_TypeDef *pGPIO, UINT32 bitValue, UINT8 dir)
 if (pGPIO != NULL)
     {
     // Enable Output
-    (dir)? (pGPIO->IO_DIR |= bitValue) : (pGPIO->IO_DIR &= ~bitValue);
+    (dir)? LEON_WR(pGPIO->IO_DIR, LEON_RD(pGPIO->IO_DIR) | bitValue) :
+           LEON_WR(pGPIO->IO_DIR, LEON_RD(pGPIO->IO_DIR) & ~bitValue);
     }
 }
 
@@ -82,7 +83,7 @@ void GPIO_SetValue(LEON_GPIO_TypeDef *pGPIO, UINT32 bitValue)
 {
 if (pGPIO != NULL)
     {
-    pGPIO->IO_OUTPUT |= bitValue;
+    LEON_WR(pGPIO->IO_OUTPUT, LEON_RD(pGPIO->IO_OUTPUT) | bitValue);
     }
 }
 
@@ -104,7 +105,7 @@ void GPIO_ClearValue(LEON_GPIO_TypeDef *pGPIO, UINT32 bitValue)
 {
 if (pGPIO != NULL)
     {
-    pGPIO->IO_OUTPUT &= ~bitValue;
+    LEON_WR(pGPIO->IO_OUTPUT, LEON_RD(pGPIO->IO_OUTPUT) & ~bitValue);
     }
 }
 
@@ -140,11 +141,123 @@ UINT32 GPIO_ReadValue(LEON_GPIO_TypeDef *pGPIO)
 {
 if (pGPIO != NULL)
     {
-    return pGPIO->IO_DATA;
+    return LEON_RD(pGPIO->IO_DATA);
     }
 
 return (0);
 }
 
 
+/*********************************************************************//**
+ * @brief       Attach an output shadow to a GPIO port. The current content
+ *              of IO_OUTPUT is read once and kept in the shadow.
+ * @param[in]   pShadow     Pointer to the shadow to initialize
+ * @param[in]   pGPIO       GPIO port the shadow is attached to
+ * @return      None
+ **********************************************************************/
+void GPIO_ShadowInit(GPIO_SHADOW_Type *pShadow, LEON_GPIO_TypeDef *pGPIO)
+{
+pShadow->pGPIO  = pGPIO;
+pShadow->Output = (pGPIO != NULL) ? LEON_RD(pGPIO->IO_OUTPUT) : 0;
+}
+
+
+/*********************************************************************//**
+ * @brief       Set output bits through the port shadow with one store.
+ * @param[in]   pShadow     Shadow attached to the GPIO port
+ * @param[in]   bitValue    Value that contains all bits on GPIO to set,
+ *                          in range from 0 to 0xFFFFFFFF.
+ * @return      None
+ **********************************************************************/
+void GPIO_ShadowSetValue(GPIO_SHADOW_Type *pShadow, UINT32 bitValue)
+{
+pShadow->Output |= bitValue;
+
+if (pShadow->pGPIO != NULL)
+    {
+    LEON_WR(pShadow->pGPIO->IO_OUTPUT, pShadow->Output);
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Clear output bits through the port shadow with one store.
+ * @param[in]   pShadow     Shadow attached to the GPIO port
+ * @param[in]   bitValue    Value that contains all bits on GPIO to clear,
+ *                          in range from 0 to 0xFFFFFFFF.
+ * @return      None
+ **********************************************************************/
+void GPIO_ShadowClearValue(GPIO_SHADOW_Type *pShadow, UINT32 bitValue)
+{
+pShadow->Output &= ~bitValue;
+
+if (pShadow->pGPIO != NULL)
+    {
+    LEON_WR(pShadow->pGPIO->IO_OUTPUT, pShadow->Output);
+    }
+}
+
 
+/*********************************************************************//**
+ * @brief       Initialize a set of GPIO ports handled as one image
+ * @param[in]   pBulk       Port set to initialize
+ * @param[in]   ppPort      Ports, in image word order
+ * @param[in]   numPorts    Number of ports, from 1 to GPIO_BULK_MAX_PORTS
+ * @return      TRUE, or FALSE if the count is out of range or a port
+ *              is NULL
+ **********************************************************************/
+BOOLEAN GPIO_BulkInit(GPIO_BULK_Type *pBulk, LEON_GPIO_TypeDef * const *ppPort, UINT32 numPorts)
+{
+UINT32 i;
+
+if ((numPorts == 0) || (numPorts > GPIO_BULK_MAX_PORTS))
+    {
+    return FALSE;
+    }
+
+for (i = 0; i < numPorts; i++)
+    {
+    if (ppPort[i] == NULL)
+        {
+        return FALSE;
+        }
+    pBulk->pPort[i] = ppPort[i];
+    }
+
+for (; i < GPIO_BULK_MAX_PORTS; i++)
+    {
+    pBulk->pPort[i] = NULL;
+    }
+
+pBulk->NumPorts = numPorts;
+
+return TRUE;
+}
+
+
+/*********************************************************************//**
+ * @brief       Read a coherent snapshot of the inputs of a port set
+ * @param[in]   pBulk       Port set
+ * @param[out]  pImage      Input image, word n holds IO_DATA of port n
+ * @return      None
+ **********************************************************************/
+void GPIO_BulkRead(const GPIO_BULK_Type *pBulk, GPIO_IMAGE_Type *pImage)
+{
+GPIO_BulkReadFast(pBulk, pImage);
+}
+
+
+/*********************************************************************//**
+ * @brief       Apply an output image to a port set, one store per port
+ * @param[in]   pBulk       Port set
+ * @param[in]   pImage      Output image, word n is written to IO_OUTPUT
+ *                          of port n
+ * @return      None
+ *
+ * Note: All output bits of the ports are written. Ports that also carry
+ * shadowed pins (GPIO_SHADOW_Type) must be updated through one method only.
+ **********************************************************************/
+void GPIO_BulkWrite(const GPIO_BULK_Type *pBulk, const GPIO_IMAGE_Type *pImage)
+{
+GPIO_BulkWriteFast(pBulk, pImage);
+}
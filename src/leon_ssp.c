@@ -2,9 +2,35 @@
 /* Includes ------------------------------------------------------------------- */
 #include "common.h"
 #include "leon_ssp.h"
+#include "leon_trace.h"
 #include "HAL.h"
 
+/* SSP wait engine tuning, may be defined in HAL.h:
+ * - SSP_WAIT_SPIN_READS: EVENT reads done back-to-back before backing off
+ * - SSP_WAIT_APB_CYCLES: estimated CPU cycles taken by one EVENT read
+ * - SSP_WAIT_LOOP_CYCLES: estimated CPU cycles taken by one delay loop pass
+ * The cycle estimates are only used when HAL.h does not provide a cycle
+ * counter through SSP_CYCLE_COUNT(). HAL.h may also provide the backoff
+ * delay through SSP_DELAY_CYCLES(n). */
+#ifndef SSP_WAIT_SPIN_READS
+#define SSP_WAIT_SPIN_READS     (4)
+#endif
+#ifndef SSP_WAIT_APB_CYCLES
+#define SSP_WAIT_APB_CYCLES     (8)
+#endif
+#ifndef SSP_WAIT_LOOP_CYCLES
+#define SSP_WAIT_LOOP_CYCLES    (4)
+#endif
+
 static void setSSPclock(LEON_SSP_TypeDef *SSPx, UINT32 target_clock);
+static UINT32 getSCKcycles(LEON_SSP_TypeDef *SSPx, UINT32 *pWordCycles);
+static void delayCycles(UINT32 cycles);
+static SSP_WAIT_Status errorStatus(UINT32 errors);
+static SSP_WAIT_Status waitLevel(LEON_SSP_TypeDef *SSPx, UINT32 events, FlagStatus level,
+                                 UINT32 stop, UINT32 timeout, UINT32 *pEvent,
+                                 UINT32 *pErrors);
+static SSP_WAIT_Status waitTransferDone(SSP_BUS_Type *pBus);
+static void driveCS(SSP_BUS_Type *pBus, const SSP_CS_Type *pCS, FunctionalState NewState);
 
 
 
@@ -66,7 +92,7 @@ if (divider_found)
     if (div16 == 16)
         reg |= SSP_MODE_DIV16;
     
-    SSPx->MODE |= reg;
+    LEON_WR(SSPx->MODE, LEON_RD(SSPx->MODE) | reg);
     }
 }
 
@@ -91,7 +117,7 @@ tmp |= SSP_MODE_REV; /* output MSB first */
 tmp |= (SSP_ConfigStruct->CPHA | SSP_ConfigStruct->CPOL | SSP_ConfigStruct->Mode |
        SSP_ConfigStruct->Databit);
 
-SSPx->MODE = tmp;
+LEON_WR(SSPx->MODE, tmp);
 
 // Set clock rate for SSP peripheral
 setSSPclock(SSPx, SSP_ConfigStruct->ClockRate);
@@ -127,7 +153,7 @@ SSP_InitStruct->Mode = SSP_MASTER_MODE;
  **********************************************************************/
 void SSP_SendData(LEON_SSP_TypeDef* SSPx, UINT32 Data)
 {
-SSPx->TX = SSP_TX_BITMASK(Data);
+LEON_WR(SSPx->TX, SSP_TX_BITMASK(Data));
 }
 
 
@@ -139,7 +165,7 @@ SSPx->TX = SSP_TX_BITMASK(Data);
 ***********************************************************************/
 UINT32 SSP_ReceiveData(LEON_SSP_TypeDef* SSPx)
 {
-return ((UINT32)(SSP_RX_BITMASK(SSPx->RX)));
+return ((UINT32)(SSP_RX_BITMASK(LEON_RD(SSPx->RX))));
 }
 
 
@@ -158,7 +184,221 @@ return ((UINT32)(SSP_RX_BITMASK(SSPx->RX)));
  **********************************************************************/
 FlagStatus SSP_GetStatus(LEON_SSP_TypeDef* SSPx, UINT32 FlagType)
 {
-return ((SSPx->EVENT & FlagType) ? SET : RESET);
+return ((LEON_RD(SSPx->EVENT) & FlagType) ? SET : RESET);
+}
+
+
+/*********************************************************************//**
+ * @brief       Read the Event register once and clear the error flags
+ *              (OV, UN, MME) that were found set
+ * @param[in]   SSPx    selected SSP peripheral
+ *
+ * @return      Content of the Event register before the flags were cleared
+ **********************************************************************/
+UINT32 SSP_ReadEvents(LEON_SSP_TypeDef* SSPx)
+{
+UINT32 event = LEON_RD(SSPx->EVENT);
+
+if (event & SSP_EVENT_ERRORS)
+    {
+    LEON_WR(SSPx->EVENT, event & SSP_EVENT_ERRORS);
+    }
+
+return event;
+}
+
+
+/*********************************************************************//**
+ * @brief       Get the SCK period and the duration of one word in system
+ *              clock cycles from the Mode register
+ * @param[in]   SSPx        selected SSP peripheral
+ * @param[out]  pWordCycles System clock cycles taken by one word, including
+ *                          the clock gap (CG) inserted between queued words
+ * @return      System clock cycles per SCK period
+ *
+ * Note: In slave mode the result is only a lower bound since SCK is
+ * generated by the master.
+ **********************************************************************/
+static UINT32 getSCKcycles(LEON_SSP_TypeDef *SSPx, UINT32 *pWordCycles)
+{
+UINT32 mode = LEON_RD(SSPx->MODE);
+UINT32 len  = (mode >> 20) & SSP_MODE_LEN_MASK;
+UINT32 sck  = ((mode & SSP_MODE_FACT) ? 2 : 4) * (((mode >> 16) & SSP_MODE_PM_MASK) + 1);
+
+if (mode & SSP_MODE_DIV16)
+    sck *= 16;
+
+*pWordCycles = sck * (((len == 0) ? 32 : (len + 1)) + ((mode >> 7) & SSP_MODE_CG_MASK));
+
+return sck;
+}
+
+
+/*********************************************************************//**
+ * @brief       Busy wait without accessing the bus
+ * @param[in]   cycles  Approximate number of system clock cycles
+ * @return      None
+ **********************************************************************/
+static void delayCycles(UINT32 cycles)
+{
+#ifdef SSP_DELAY_CYCLES
+SSP_DELAY_CYCLES(cycles);
+#else
+volatile UINT32 n = cycles / SSP_WAIT_LOOP_CYCLES;
+
+while (n > 0)
+    {
+    n--;
+    }
+#endif
+}
+
+
+/*********************************************************************//**
+ * @brief       Translate error events to a wait result
+ * @param[in]   errors  Error bits from the Event register, not 0
+ * @return      Wait result of the most severe error
+ **********************************************************************/
+static SSP_WAIT_Status errorStatus(UINT32 errors)
+{
+if (errors & SSP_EVENT_MME)
+    {
+    return SSP_WAIT_MME;
+    }
+
+return (errors & SSP_EVENT_OV) ? SSP_WAIT_OVERRUN : SSP_WAIT_UNDERRUN;
+}
+
+
+/*********************************************************************//**
+ * @brief       Wait until the given Event bits reach a level
+ * @param[in]   SSPx    selected SSP peripheral
+ * @param[in]   events  Event bits to watch
+ * @param[in]   level   SET: wait until any of the bits is set
+ *                      RESET: wait until all of the bits are cleared
+ * @param[in]   stop    Error events (SSP_EVENT_ERRORS bits) that end the
+ *                      wait, the others are only cleared and reported
+ * @param[in]   timeout Timeout in system clock cycles, or SSP_WAIT_FOREVER
+ * @param[out]  pEvent  Last Event register value read, may be NULL
+ * @param[out]  pErrors Error events seen are or'ed into it, may be NULL
+ * @return      Wait result
+ *
+ * Note: The register is read SSP_WAIT_SPIN_READS times back-to-back, then
+ * the delay between reads starts at one SCK period and doubles up to the
+ * duration of one word so that the APB bus is left to other masters.
+ **********************************************************************/
+static SSP_WAIT_Status waitLevel(LEON_SSP_TypeDef *SSPx, UINT32 events, FlagStatus level,
+                                 UINT32 stop, UINT32 timeout, UINT32 *pEvent,
+                                 UINT32 *pErrors)
+{
+UINT32 event;
+UINT32 errors;
+UINT32 delay;
+UINT32 maxDelay;
+UINT32 spins   = 0;
+UINT32 elapsed = 0;
+#ifdef SSP_CYCLE_COUNT
+UINT32 start = (UINT32)SSP_CYCLE_COUNT();
+#endif
+
+delay = getSCKcycles(SSPx, &maxDelay);
+
+while (1)
+    {
+    event = SSP_ReadEvents(SSPx);
+    errors = event & SSP_EVENT_ERRORS & ~events;
+
+    if (pEvent != NULL)
+        {
+        *pEvent = event;
+        }
+
+    if (pErrors != NULL)
+        {
+        *pErrors |= errors;
+        }
+
+    if (errors & stop)
+        {
+        return errorStatus(errors & stop);
+        }
+
+    if (((event & events) != 0) == (level == SET))
+        {
+        return SSP_WAIT_OK;
+        }
+
+#ifdef SSP_CYCLE_COUNT
+    elapsed = (UINT32)SSP_CYCLE_COUNT() - start;
+#else
+    elapsed += SSP_WAIT_APB_CYCLES;
+#endif
+
+    if ((timeout != SSP_WAIT_FOREVER) && (elapsed >= timeout))
+        {
+        return SSP_WAIT_TIMEOUT;
+        }
+
+    if (spins < SSP_WAIT_SPIN_READS)
+        {
+        spins++;
+        }
+    else
+        {
+        delayCycles(delay);
+#ifndef SSP_CYCLE_COUNT
+        elapsed += delay;
+#endif
+        delay = ((delay << 1) < maxDelay) ? (delay << 1) : maxDelay;
+        }
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Wait until any of the given Event bits is set. Error
+ *              events that are not part of the set end the wait and are
+ *              cleared.
+ * @param[in]   SSPx    selected SSP peripheral
+ * @param[in]   events  SSP_EVENT_xxx bits to wait for
+ * @param[in]   timeout Timeout in system clock cycles, or SSP_WAIT_FOREVER
+ * @param[out]  pEvent  Last Event register value read, may be NULL
+ * @return      SSP_WAIT_OK if an event is set, SSP_WAIT_TIMEOUT, or
+ *              SSP_WAIT_OVERRUN / SSP_WAIT_UNDERRUN / SSP_WAIT_MME
+ **********************************************************************/
+SSP_WAIT_Status SSP_WaitEvent(LEON_SSP_TypeDef* SSPx, UINT32 events,
+                              UINT32 timeout, UINT32 *pEvent)
+{
+return waitLevel(SSPx, events, SET, SSP_EVENT_ERRORS, timeout, pEvent, NULL);
+}
+
+
+/*********************************************************************//**
+ * @brief       Wait until no transfer is in progress (TIP cleared)
+ * @param[in]   SSPx    selected SSP peripheral
+ * @param[in]   timeout Timeout in system clock cycles, or SSP_WAIT_FOREVER
+ * @return      SSP_WAIT_OK if the core is idle, SSP_WAIT_TIMEOUT, or
+ *              SSP_WAIT_OVERRUN / SSP_WAIT_UNDERRUN / SSP_WAIT_MME
+ **********************************************************************/
+SSP_WAIT_Status SSP_WaitIdle(LEON_SSP_TypeDef* SSPx, UINT32 timeout)
+{
+return waitLevel(SSPx, SSP_EVENT_TIP, RESET, SSP_EVENT_ERRORS, timeout, NULL, NULL);
+}
+
+
+/*********************************************************************//**
+ * @brief       Duration of one word with the current Mode register
+ * @param[in]   SSPx    selected SSP peripheral
+ * @return      System clock cycles taken by one word and the clock gap
+ *              that follows it in a queue (a lower bound in slave mode)
+ **********************************************************************/
+UINT32 SSP_GetWordCycles(LEON_SSP_TypeDef* SSPx)
+{
+UINT32 wordCycles;
+
+getSCKcycles(SSPx, &wordCycles);
+
+return wordCycles;
 }
 
 
@@ -173,11 +413,245 @@ void SSP_Cmd(LEON_SSP_TypeDef* SSPx, FunctionalState NewState)
 {
 if (NewState == ENABLE)
     {
-    SSPx->MODE |= SSP_MODE_EN;
+    LEON_WR(SSPx->MODE, LEON_RD(SSPx->MODE) | SSP_MODE_EN);
+    }
+else
+    {
+    LEON_WR(SSPx->MODE, LEON_RD(SSPx->MODE) & (~SSP_MODE_EN) & SSP_MODE_EN);
+    }
+}
+
+
+
+/*********************************************************************//**
+ * @brief       Wait until the words sent on the bus have been transferred
+ *              and the last transfer has finished (TIP cleared)
+ * @param[in]   pBus    SSP bus state
+ *
+ * @return      SSP_WAIT_OK, SSP_WAIT_TIMEOUT, SSP_WAIT_MME, or
+ *              SSP_WAIT_OVERRUN / SSP_WAIT_UNDERRUN if such an event was
+ *              seen while the words went out
+ *
+ * Note: OV and UN do not end the wait, the chip select must stay asserted
+ * until the queue has drained whatever happened to the received words.
+ * A write-only transfer that never reads RX overruns the receive queue.
+ * Only MME, which disables the core, and the timeout end it early.
+ * Without a bus timeout each wait is limited to the time of a full
+ * queue plus the word in the shift register and one more word for the
+ * backoff granularity of the wait, so that a disabled core or a stopped
+ * SCK cannot hang the deselect.
+ * NF only tells that the queue has room, so the queue is known to be
+ * empty through LT. LST is armed once here instead of before every word.
+ * TIP stays set until the queue is empty and the last transfer is done,
+ * so if it is clear after arming the words have all gone out and no LT
+ * will come; if it is set, the last word completes after the arming and
+ * sets LT.
+ **********************************************************************/
+static SSP_WAIT_Status waitTransferDone(SSP_BUS_Type *pBus)
+{
+LEON_SSP_TypeDef *SSPx = pBus->SSPx;
+SSP_WAIT_Status ret = SSP_WAIT_OK;
+UINT32 timeout = pBus->Timeout;
+UINT32 errors = 0;
+UINT32 depth;
+
+if (timeout == 0)
+    {
+    depth = ((LEON_RD(SSPx->CAP) >> 8) & SSP_CAP_FDEPTH_MASK) + 1;
+    timeout = (depth + 2) * SSP_GetWordCycles(SSPx);
+    }
+
+if (pBus->Sent)
+    {
+    LEON_WR(SSPx->EVENT, SSP_EVENT_LT);
+    LEON_WR(SSPx->CMD, SSP_CMD_LST);
+
+    if (LEON_RD(SSPx->EVENT) & SSP_EVENT_TIP)
+        {
+        ret = waitLevel(SSPx, SSP_EVENT_LT, SET, SSP_EVENT_MME, timeout, NULL, &errors);
+        }
+    }
+
+if (ret == SSP_WAIT_OK)
+    {
+    ret = waitLevel(SSPx, SSP_EVENT_TIP, RESET, SSP_EVENT_MME, timeout, NULL, &errors);
+    }
+
+if ((ret == SSP_WAIT_OK) && errors)
+    {
+    ret = errorStatus(errors);
+    }
+
+LEON_WR(SSPx->EVENT, SSP_EVENT_LT);
+pBus->Sent = FALSE;
+
+return ret;
+}
+
+
+/*********************************************************************//**
+ * @brief       Drive a chip select line to its active or inactive level
+ * @param[in]   pBus        SSP bus the chip select belongs to
+ * @param[in]   pCS         Chip select to drive
+ * @param[in]   NewState    ENABLE to assert, DISABLE to deassert
+ * @return      None
+ **********************************************************************/
+static void driveCS(SSP_BUS_Type *pBus, const SSP_CS_Type *pCS, FunctionalState NewState)
+{
+if (pCS->Type == SSP_CS_NATIVE)
+    {
+    /* SLAVESEL lines are active low */
+    (NewState == ENABLE)? (pBus->SlaveSel &= ~pCS->Mask) : (pBus->SlaveSel |= pCS->Mask);
+    LEON_WR(pBus->SSPx->SLAVESEL, pBus->SlaveSel);
+    }
+else if ((NewState == ENABLE) == (pCS->Polarity == SSP_CS_ACTIVE_HI))
+    {
+    GPIO_ShadowSetValue(pCS->pPort, pCS->Mask);
     }
 else
     {
-    SSPx->MODE &= (~SSP_MODE_EN) & SSP_MODE_EN;
+    GPIO_ShadowClearValue(pCS->pPort, pCS->Mask);
     }
 }
 
+
+/*********************************************************************//**
+ * @brief       Initialize the chip select state of an SSP bus. All native
+ *              slave select lines are deasserted. The deselect waits
+ *              are limited to the time of a full queue, pBus->Timeout may
+ *              be set after this call to use another limit.
+ * @param[in]   pBus    Pointer to the bus state to initialize
+ * @param[in]   SSPx    selected SSP peripheral
+ * @return      None
+ **********************************************************************/
+void SSP_BusInit(SSP_BUS_Type *pBus, LEON_SSP_TypeDef *SSPx)
+{
+pBus->SSPx = SSPx;
+pBus->Active = NULL;
+pBus->SlaveSel = 0xFFFFFFFF;
+pBus->Sent = FALSE;
+pBus->Timeout = 0;
+
+if (LEON_RD(SSPx->CAP) & SSP_CAP_SSEN)
+    {
+    LEON_WR(SSPx->SLAVESEL, pBus->SlaveSel);
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Describe a chip select driven by a native SLAVESEL line
+ * @param[in]   pCS     Pointer to the chip select to initialize
+ * @param[in]   SSPx    selected SSP peripheral
+ * @param[in]   line    Slave select line, in range from 0 to SSSZ-1
+ * @return      SUCCESS if the core implements the line, ERROR otherwise
+ **********************************************************************/
+Status SSP_CS_InitNative(SSP_CS_Type *pCS, LEON_SSP_TypeDef *SSPx, UINT32 line)
+{
+UINT32 cap = LEON_RD(SSPx->CAP);
+
+if (!(cap & SSP_CAP_SSEN) || (line >= ((cap >> 24) & SSP_CAP_SSSZ_MASK)))
+    {
+    return ERROR;
+    }
+
+pCS->Type = SSP_CS_NATIVE;
+pCS->Mask = SSP_SLAVESEL_SS(line);
+pCS->pPort = NULL;
+pCS->Polarity = SSP_CS_ACTIVE_LO;
+
+return SUCCESS;
+}
+
+
+/*********************************************************************//**
+ * @brief       Describe a chip select driven by a GPIO pin. The pin is
+ *              configured as output and driven to its inactive level.
+ * @param[in]   pCS         Pointer to the chip select to initialize
+ * @param[in]   pPort       Output shadow of the GPIO port
+ * @param[in]   pin         Pin number on the GPIO port, in range from 0 to 31
+ * @param[in]   polarity    SSP_CS_ACTIVE_LO or SSP_CS_ACTIVE_HI
+ * @return      None
+ **********************************************************************/
+void SSP_CS_InitGPIO(SSP_CS_Type *pCS, GPIO_SHADOW_Type *pPort, UINT32 pin, UINT32 polarity)
+{
+pCS->Type = SSP_CS_GPIO;
+pCS->Mask = ((UINT32)1 << pin);
+pCS->pPort = pPort;
+pCS->Polarity = polarity;
+
+(polarity == SSP_CS_ACTIVE_HI)? GPIO_ShadowClearValue(pPort, pCS->Mask) :
+                                GPIO_ShadowSetValue(pPort, pCS->Mask);
+GPIO_SetDir(pPort->pGPIO, pCS->Mask, GPIO_DIRECTION_OUTPUT);
+}
+
+
+/*********************************************************************//**
+ * @brief       Select a device on the bus. If the device is already
+ *              selected nothing is done, otherwise the previous device is
+ *              deselected once its transfer has finished.
+ * @param[in]   pBus    SSP bus state
+ * @param[in]   pCS     Chip select of the device to address
+ * @return      SSP_WAIT_OK, SSP_WAIT_TIMEOUT, or the error that ended the
+ *              transfer of the previously selected device
+ **********************************************************************/
+SSP_WAIT_Status SSP_CS_Select(SSP_BUS_Type *pBus, const SSP_CS_Type *pCS)
+{
+SSP_WAIT_Status ret;
+
+if (pBus->Active == pCS)
+    {
+    return SSP_WAIT_OK;
+    }
+
+ret = SSP_CS_Deselect(pBus);
+
+driveCS(pBus, pCS, ENABLE);
+pBus->Active = pCS;
+
+return ret;
+}
+
+
+/*********************************************************************//**
+ * @brief       Deselect the currently selected device as soon as the
+ *              ongoing transfer has finished (TIP cleared)
+ * @param[in]   pBus    SSP bus state
+ * @return      SSP_WAIT_OK, SSP_WAIT_TIMEOUT, or the error that ended
+ *              the transfer. The device is deselected in all cases.
+ **********************************************************************/
+SSP_WAIT_Status SSP_CS_Deselect(SSP_BUS_Type *pBus)
+{
+SSP_WAIT_Status ret;
+
+if (pBus->Active == NULL)
+    {
+    return SSP_WAIT_OK;
+    }
+
+ret = waitTransferDone(pBus);
+
+driveCS(pBus, pBus->Active, DISABLE);
+pBus->Active = NULL;
+
+return ret;
+}
+
+
+/*********************************************************************//**
+ * @brief       Transmit a single data to the selected device. Words sent
+ *              to a device selected through the bus must use this function
+ *              so that the deselect knows when the last one has finished.
+ * @param[in]   pBus    SSP bus state
+ * @param[in]   Data    Data to transmit
+ * @return      none
+ *
+ * Note: Same single TX write as SSP_SendData(), the completion of the last
+ * word is armed once by the deselect.
+ **********************************************************************/
+void SSP_BusSendData(SSP_BUS_Type *pBus, UINT32 Data)
+{
+LEON_WR(pBus->SSPx->TX, SSP_TX_BITMASK(Data));
+
+pBus->Sent = TRUE;
+}
@@ -0,0 +1,313 @@
+
+/* Includes ------------------------------------------------------------------- */
+#include "common.h"
+#include "leon_ssp_acq.h"
+#include "leon_trace.h"
+#include "HAL.h"
+
+static void resetDecimator(SSP_ACQ_Type *pAcq);
+static void emitFrame(SSP_ACQ_Type *pAcq);
+static void abortScan(SSP_ACQ_Type *pAcq, UINT32 inFlight);
+
+
+
+/*********************************************************************//**
+ * @brief       Initialize a frame ring
+ * @param[in]   pRing       Ring to initialize
+ * @param[in]   pFrames     Frame storage
+ * @param[in]   count       Number of frames, must be a power of two
+ * @return      SUCCESS, or ERROR if count is not a power of two
+ **********************************************************************/
+Status SSP_ACQ_RingInit(SSP_ACQ_RING_Type *pRing, SSP_ACQ_FRAME_Type *pFrames, UINT32 count)
+{
+if ((count == 0) || (count & (count - 1)))
+    {
+    return ERROR;
+    }
+
+pRing->pFrames = pFrames;
+pRing->SizeMask = count - 1;
+pRing->Head = 0;
+pRing->Tail = 0;
+pRing->Dropped = 0;
+
+return SUCCESS;
+}
+
+
+/*********************************************************************//**
+ * @brief       Get the oldest frame of the ring without copying it
+ * @param[in]   pRing       Ring to read from (consumer side)
+ * @return      Pointer to the frame, or NULL if the ring is empty. The
+ *              frame stays valid until SSP_ACQ_RingRelease() is called.
+ **********************************************************************/
+const SSP_ACQ_FRAME_Type *SSP_ACQ_RingPeek(SSP_ACQ_RING_Type *pRing)
+{
+UINT32 tail = pRing->Tail;
+
+if (pRing->Head == tail)
+    {
+    return NULL;
+    }
+
+SSP_BARRIER();
+
+return &pRing->pFrames[tail & pRing->SizeMask];
+}
+
+
+/*********************************************************************//**
+ * @brief       Give the frame returned by SSP_ACQ_RingPeek() back to the
+ *              producer
+ * @param[in]   pRing       Ring to read from (consumer side)
+ * @return      None
+ **********************************************************************/
+void SSP_ACQ_RingRelease(SSP_ACQ_RING_Type *pRing)
+{
+SSP_BARRIER();
+
+pRing->Tail = pRing->Tail + 1;
+}
+
+
+/*********************************************************************//**
+ * @brief       Initialize an acquisition pipeline. The SSP peripheral must
+ *              already be configured (SSP_Init) and enabled (SSP_Cmd).
+ * @param[in]   pAcq        Pipeline state to initialize
+ * @param[in]   SSPx        selected SSP peripheral
+ * @param[in]   pCfg        Pointer to a SSP_ACQ_CFG_Type structure
+ * @param[in]   pRing       Ring receiving the decimated frames
+ * @return      SUCCESS, or ERROR if the configuration is out of range or
+ *              the decimator registers would overflow
+ **********************************************************************/
+Status SSP_ACQ_Init(SSP_ACQ_Type *pAcq, LEON_SSP_TypeDef *SSPx,
+                    const SSP_ACQ_CFG_Type *pCfg, SSP_ACQ_RING_Type *pRing)
+{
+if ((pCfg->NumChannels == 0) || (pCfg->NumChannels > SSP_ACQ_MAX_CHANNELS) ||
+    (pCfg->Order == 0) || (pCfg->Order > SSP_ACQ_MAX_ORDER) ||
+    (pCfg->Bits < 4) || (pCfg->Bits > 16) || (pCfg->Latency > 1) ||
+    ((pCfg->Bits + pCfg->Order * pCfg->DecimLog2) > 32))
+    {
+    return ERROR;
+    }
+
+pAcq->SSPx = SSPx;
+pAcq->Cfg = *pCfg;
+pAcq->pRing = pRing;
+pAcq->Depth = ((LEON_RD(SSPx->CAP) >> 8) & SSP_CAP_FDEPTH_MASK) + 1;
+pAcq->Mask = ((UINT32)1 << pCfg->Bits) - 1;
+pAcq->Offset = (UINT32)1 << (pCfg->Bits - 1);
+pAcq->Flip = (pCfg->Signed) ? pAcq->Offset : 0;
+pAcq->Seq = 0;
+
+resetDecimator(pAcq);
+
+return SUCCESS;
+}
+
+
+/*********************************************************************//**
+ * @brief       Restart the decimation of all channels from zero
+ * @param[in]   pAcq        Pipeline state
+ * @return      None
+ **********************************************************************/
+static void resetDecimator(SSP_ACQ_Type *pAcq)
+{
+UINT32 ch;
+UINT32 k;
+
+pAcq->Phase = 0;
+
+for (ch = 0; ch < SSP_ACQ_MAX_CHANNELS; ch++)
+    {
+    for (k = 0; k < 2 * SSP_ACQ_MAX_ORDER; k++)
+        {
+        pAcq->State[ch][k] = 0;
+        }
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Run the comb stages of all channels and put the frame into
+ *              the ring. The frame is dropped if the ring is full.
+ * @param[in]   pAcq        Pipeline state
+ * @return      None
+ **********************************************************************/
+static void emitFrame(SSP_ACQ_Type *pAcq)
+{
+SSP_ACQ_RING_Type *pRing = pAcq->pRing;
+SSP_ACQ_FRAME_Type *pFrame;
+UINT32 order = pAcq->Cfg.Order;
+UINT32 shift = order * pAcq->Cfg.DecimLog2;
+UINT32 head = pRing->Head;
+UINT32 *p;
+UINT32 ch;
+UINT32 k;
+UINT32 y;
+UINT32 t;
+
+if ((head - pRing->Tail) > pRing->SizeMask)
+    {
+    pRing->Dropped++;
+    pFrame = NULL;
+    }
+else
+    {
+    pFrame = &pRing->pFrames[head & pRing->SizeMask];
+    pFrame->Seq = pAcq->Seq;
+    }
+
+pAcq->Seq++;
+
+for (ch = 0; ch < pAcq->Cfg.NumChannels; ch++)
+    {
+    p = pAcq->State[ch];
+    y = p[order - 1];
+
+    /* Combs run even for a dropped frame to keep their delays current */
+    for (k = order; k < 2 * order; k++)
+        {
+        t = y;
+        y -= p[k];
+        p[k] = t;
+        }
+
+    if (pFrame != NULL)
+        {
+        pFrame->Sample[ch] = (INT16)((INT32)y >> shift);
+        }
+    }
+
+if (pFrame != NULL)
+    {
+    SSP_BARRIER();
+    pRing->Head = head + 1;
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Recover from an aborted scan: receive and discard the words
+ *              still in flight so that the next scan does not read them as
+ *              its first channels, and restart the decimation since the
+ *              current frame misses samples.
+ * @param[in]   pAcq        Pipeline state
+ * @param[in]   inFlight    Words sent and not received
+ * @return      None
+ *
+ * Note: The wait is limited to the time of the words in flight plus one
+ * word for the backoff granularity of the wait, whatever Cfg.Timeout is.
+ **********************************************************************/
+static void abortScan(SSP_ACQ_Type *pAcq, UINT32 inFlight)
+{
+LEON_SSP_TypeDef *SSPx = pAcq->SSPx;
+UINT32 timeout = (inFlight + 2) * SSP_GetWordCycles(SSPx);
+SSP_WAIT_Status ret;
+
+do
+    {
+    ret = SSP_WaitIdle(SSPx, timeout);
+    } while ((ret == SSP_WAIT_OVERRUN) || (ret == SSP_WAIT_UNDERRUN));
+
+while (LEON_RD(SSPx->EVENT) & SSP_EVENT_NE)
+    {
+    LEON_RD(SSPx->RX);
+    }
+
+resetDecimator(pAcq);
+}
+
+
+/*********************************************************************//**
+ * @brief       Convert every channel once and feed the samples to the
+ *              decimator. A frame is emitted every 2^DecimLog2 scans.
+ * @param[in]   pAcq        Pipeline state
+ * @return      SSP_WAIT_OK, or the wait result that aborted the scan. An
+ *              aborted scan leaves the queues empty and restarts the
+ *              decimation, the frame being accumulated is lost.
+ *
+ * Note: At most Depth words are in flight so the receive queue can not
+ * overrun. Received words are only waited for when the queue is empty.
+ **********************************************************************/
+SSP_WAIT_Status SSP_ACQ_Scan(SSP_ACQ_Type *pAcq)
+{
+LEON_SSP_TypeDef *SSPx = pAcq->SSPx;
+const UINT32 *pCommand = pAcq->Cfg.pCommand;
+UINT32 channels = pAcq->Cfg.NumChannels;
+UINT32 latency = pAcq->Cfg.Latency;
+UINT32 total = channels + latency;
+UINT32 order = pAcq->Cfg.Order;
+UINT32 shift = pAcq->Cfg.Shift;
+UINT32 mask = pAcq->Mask;
+UINT32 offset = pAcq->Offset;
+UINT32 flip = pAcq->Flip;
+SSP_WAIT_Status ret;
+UINT32 tx = 0;
+UINT32 rx;
+UINT32 word;
+UINT32 x;
+UINT32 *p;
+
+/* Trailing words of a pipelined converter repeat the first command */
+while ((tx < total) && (tx < pAcq->Depth))
+    {
+    LEON_WR(SSPx->TX, pCommand[(tx < channels) ? tx : 0]);
+    tx++;
+    }
+
+for (rx = 0; rx < total; rx++)
+    {
+    if (!(LEON_RD(SSPx->EVENT) & SSP_EVENT_NE))
+        {
+        ret = SSP_WaitEvent(SSPx, SSP_EVENT_NE, pAcq->Cfg.Timeout, NULL);
+        if (ret != SSP_WAIT_OK)
+            {
+            abortScan(pAcq, tx - rx);
+            return ret;
+            }
+        }
+
+    word = LEON_RD(SSPx->RX);
+
+    if (tx < total)
+        {
+        LEON_WR(SSPx->TX, pCommand[(tx < channels) ? tx : 0]);
+        tx++;
+        }
+
+    if (rx < latency)
+        {
+        continue;
+        }
+
+    /* Center the sample on zero and run the integrators */
+    x = (((word >> shift) & mask) ^ flip) - offset;
+    p = pAcq->State[rx - latency];
+
+    p[0] += x;
+    if (order > 1)
+        {
+        p[1] += p[0];
+        if (order > 2)
+            {
+            p[2] += p[1];
+            }
+        }
+    }
+
+if (++pAcq->Phase >> pAcq->Cfg.DecimLog2)
+    {
+    pAcq->Phase = 0;
+    emitFrame(pAcq);
+    }
+
+word = SSP_ReadEvents(SSPx) & SSP_EVENT_ERRORS;
+
+if (word & SSP_EVENT_MME)
+    {
+    return SSP_WAIT_MME;
+    }
+
+return (word & SSP_EVENT_OV) ? SSP_WAIT_OVERRUN : SSP_WAIT_OK;
+}
@@ -0,0 +1,246 @@
+
+/* Includes ------------------------------------------------------------------- */
+#include "common.h"
+#include "leon_ssp_slave.h"
+#include "leon_trace.h"
+#include "HAL.h"
+
+static void completeFrame(SSP_SLV_Type *pSlv);
+
+
+
+/*********************************************************************//**
+ * @brief       Initialize the slave receiver and enable the NE and OV
+ *              interrupts. The SSP peripheral must be configured in slave
+ *              mode (SSP_Init) and enabled (SSP_Cmd).
+ * @param[in]   pSlv        Receiver state to initialize
+ * @param[in]   SSPx        selected SSP peripheral
+ * @param[in]   pCfg        Pointer to a SSP_SLV_CFG_Type structure
+ * @param[in]   pBuf0       First frame buffer, FrameLen words
+ * @param[in]   pBuf1       Second frame buffer, FrameLen words
+ * @return      SUCCESS, or ERROR if FrameLen is 0
+ **********************************************************************/
+Status SSP_SLV_Init(SSP_SLV_Type *pSlv, LEON_SSP_TypeDef *SSPx, const SSP_SLV_CFG_Type *pCfg,
+                    UINT32 *pBuf0, UINT32 *pBuf1)
+{
+UINT32 i;
+
+if (pCfg->FrameLen == 0)
+    {
+    return ERROR;
+    }
+
+pSlv->SSPx = SSPx;
+pSlv->Cfg = *pCfg;
+pSlv->Depth = ((LEON_RD(SSPx->CAP) >> 8) & SSP_CAP_FDEPTH_MASK) + 1;
+pSlv->Frame[0].pData = pBuf0;
+pSlv->Frame[1].pData = pBuf1;
+
+for (i = 0; i < SSP_SLV_NUM_BUFFERS; i++)
+    {
+    pSlv->Frame[i].Seq = 0;
+    pSlv->Frame[i].Overruns = 0;
+    pSlv->Full[i] = 0;
+    }
+
+pSlv->Fill = 0;
+pSlv->Pos = 0;
+pSlv->Synced = (pCfg->SyncMask == 0);
+pSlv->Seq = 0;
+pSlv->Overruns = 0;
+pSlv->Dropped = 0;
+pSlv->Resyncs = 0;
+
+/* Stale data and events from before the start are discarded */
+while (LEON_RD(SSPx->EVENT) & SSP_EVENT_NE)
+    {
+    (void)LEON_RD(SSPx->RX);
+    }
+LEON_WR(SSPx->EVENT, SSP_EVENT_W1C);
+
+LEON_WR(SSPx->MASK, LEON_RD(SSPx->MASK) | SSP_MASK_NEE | SSP_MASK_OVE);
+
+return SUCCESS;
+}
+
+
+/*********************************************************************//**
+ * @brief       Disable the receiver interrupts
+ * @param[in]   pSlv        Receiver state
+ * @return      None
+ **********************************************************************/
+void SSP_SLV_Stop(SSP_SLV_Type *pSlv)
+{
+LEON_WR(pSlv->SSPx->MASK, LEON_RD(pSlv->SSPx->MASK) & ~(SSP_MASK_NEE | SSP_MASK_OVE));
+}
+
+
+/*********************************************************************//**
+ * @brief       Hand the buffer being filled to the application and switch
+ *              to the other one. If the application still holds the other
+ *              buffer the frame is dropped and the buffer is refilled.
+ * @param[in]   pSlv        Receiver state
+ * @return      None
+ **********************************************************************/
+static void completeFrame(SSP_SLV_Type *pSlv)
+{
+UINT32 fill = pSlv->Fill;
+UINT32 next = fill ^ 1;
+
+pSlv->Pos = 0;
+pSlv->Synced = (pSlv->Cfg.SyncMask == 0);
+
+if (pSlv->Full[next])
+    {
+    pSlv->Dropped++;
+    pSlv->Frame[fill].Overruns = 0;
+    return;
+    }
+
+pSlv->Frame[fill].Seq = pSlv->Seq++;
+
+/* Frame words and header are stored before the application can see it */
+SSP_BARRIER();
+pSlv->Full[fill] = 1;
+
+pSlv->Fill = next;
+pSlv->Frame[next].Overruns = 0;
+}
+
+
+/*********************************************************************//**
+ * @brief       SSP interrupt handler of the slave receiver. Drains the
+ *              receive queue into the current frame buffer and accounts
+ *              overruns to the frame being received.
+ * @param[in]   pSlv        Receiver state
+ * @return      None
+ *
+ * Note: The Event register is read before each RX read. GRSPI has no
+ * receive level count and NE only tells that at least one word is queued,
+ * so a burst of reads without it could read an empty queue.
+ **********************************************************************/
+void SSP_SLV_IRQHandler(SSP_SLV_Type *pSlv)
+{
+LEON_SSP_TypeDef *SSPx = pSlv->SSPx;
+UINT32 frameLen = pSlv->Cfg.FrameLen;
+UINT32 syncMask = pSlv->Cfg.SyncMask;
+UINT32 syncWord = pSlv->Cfg.SyncWord;
+UINT32 *pData = pSlv->Frame[pSlv->Fill].pData;
+UINT32 pos = pSlv->Pos;
+UINT32 event;
+UINT32 word;
+UINT32 i;
+
+event = LEON_RD(SSPx->EVENT);
+
+while (1)
+    {
+    if (event & SSP_EVENT_OV)
+        {
+        LEON_WR(SSPx->EVENT, SSP_EVENT_OV);
+        pSlv->Overruns++;
+
+        if (!syncMask)
+            {
+            /* Words were lost: the frame is kept but flagged */
+            pSlv->Frame[pSlv->Fill].Overruns++;
+            }
+        else
+            {
+            /* The queue was full when words were lost, so the words still
+               queued come before the loss. They and the frame being
+               received are dropped, and the next sync word read after them
+               starts a clean frame. Completing the frame with words of the
+               next one would take its sync word and lose it as well. */
+            for (i = 0; (i < pSlv->Depth) && (LEON_RD(SSPx->EVENT) & SSP_EVENT_NE); i++)
+                {
+                (void)LEON_RD(SSPx->RX);
+                }
+            if (pos != 0)
+                {
+                pSlv->Resyncs++;
+                }
+            pos = 0;
+            pSlv->Synced = FALSE;
+            pSlv->Frame[pSlv->Fill].Overruns = 0;
+            event = LEON_RD(SSPx->EVENT);
+            continue;
+            }
+        }
+
+    if (!(event & SSP_EVENT_NE))
+        {
+        break;
+        }
+
+    word = LEON_RD(SSPx->RX);
+
+    if (!pSlv->Synced)
+        {
+        if ((word & syncMask) != syncWord)
+            {
+            event = LEON_RD(SSPx->EVENT);
+            continue;
+            }
+        pSlv->Synced = TRUE;
+        }
+    else if ((pos == 0) && syncMask && ((word & syncMask) != syncWord))
+        {
+        pSlv->Resyncs++;
+        pSlv->Synced = FALSE;
+        event = LEON_RD(SSPx->EVENT);
+        continue;
+        }
+
+    pData[pos++] = word;
+
+    if (pos == frameLen)
+        {
+        pSlv->Pos = pos;
+        completeFrame(pSlv);
+        pData = pSlv->Frame[pSlv->Fill].pData;
+        pos = 0;
+        }
+
+    event = LEON_RD(SSPx->EVENT);
+    }
+
+pSlv->Pos = pos;
+}
+
+
+/*********************************************************************//**
+ * @brief       Get the completed frame, without copying it
+ * @param[in]   pSlv        Receiver state
+ * @return      Frame owned by the application until SSP_SLV_ReleaseFrame()
+ *              is called, or NULL if no frame is complete
+ **********************************************************************/
+SSP_SLV_FRAME_Type *SSP_SLV_GetFrame(SSP_SLV_Type *pSlv)
+{
+UINT32 i;
+
+for (i = 0; i < SSP_SLV_NUM_BUFFERS; i++)
+    {
+    if (pSlv->Full[i])
+        {
+        SSP_BARRIER();
+        return &pSlv->Frame[i];
+        }
+    }
+
+return NULL;
+}
+
+
+/*********************************************************************//**
+ * @brief       Give a frame buffer back to the receiver
+ * @param[in]   pSlv        Receiver state
+ * @param[in]   pFrame      Frame returned by SSP_SLV_GetFrame()
+ * @return      None
+ **********************************************************************/
+void SSP_SLV_ReleaseFrame(SSP_SLV_Type *pSlv, SSP_SLV_FRAME_Type *pFrame)
+{
+/* Frame reads of the application are done before the buffer is refilled */
+SSP_BARRIER();
+pSlv->Full[pFrame - pSlv->Frame] = 0;
+}
@@ -0,0 +1,336 @@
+
+/* Includes ------------------------------------------------------------------- */
+#include "common.h"
+#include "leon_trace.h"
+#include "HAL.h"
+
+#ifdef LEON_TRACE
+
+#ifndef LEON_TRACE_CYCLES
+#ifdef SSP_CYCLE_COUNT
+#define LEON_TRACE_CYCLES()     ((UINT32)SSP_CYCLE_COUNT())
+#endif
+#endif
+
+#if !defined(LEON_TRACE_LOCK) || !defined(LEON_TRACE_UNLOCK)
+#error "LEON_TRACE needs LEON_TRACE_LOCK() and LEON_TRACE_UNLOCK() in HAL.h"
+#endif
+
+/** @brief Attached register block */
+typedef struct {
+    unsigned long Base;        /** Address of the first register           */
+    UINT32 Size;               /** Size of the block in bytes              */
+    UINT32 Kind;               /** LEON_TRACE_KIND_xxx                     */
+} LEON_TRACE_DEV_Type;
+
+/** @brief Trace recorder state */
+typedef struct {
+    UINT8 *pBuf;               /** Block storage                           */
+    UINT32 NumBlocks;          /** Number of blocks in pBuf                */
+    UINT32 Block;              /** Block being filled                      */
+    UINT32 Pos;                /** Write position inside the block         */
+    UINT32 Filled;             /** Blocks holding data                     */
+    UINT32 LastCycles;         /** Cycle stamp of the previous record      */
+    UINT32 LastValue;          /** Value of the previous record            */
+    UINT32 Stamp;              /** Access count, when no cycle counter     */
+    UINT32 Enabled;            /** Recording is on                         */
+    UINT32 NumDev;             /** Attached register blocks                */
+    LEON_TRACE_DEV_Type Dev[LEON_TRACE_MAX_DEVICES];
+} LEON_TRACE_Type;
+
+static LEON_TRACE_Type trace;
+
+static void putU16(UINT8 *p, UINT32 v);
+static void putU32(UINT8 *p, UINT32 v);
+static UINT8 *putVarint(UINT8 *p, UINT32 v);
+static void openBlock(void);
+static UINT32 lookupTag(const volatile UINT32 *pReg);
+static void record(UINT32 tag, UINT32 value);
+
+
+
+/*********************************************************************//**
+ * @brief       Store little endian integers
+ * @param[in]   p       Destination
+ * @param[in]   v       Value to store
+ * @return      None
+ **********************************************************************/
+static void putU16(UINT8 *p, UINT32 v)
+{
+p[0] = (UINT8)v;
+p[1] = (UINT8)(v >> 8);
+}
+
+static void putU32(UINT8 *p, UINT32 v)
+{
+putU16(p, v);
+putU16(p + 2, v >> 16);
+}
+
+
+/*********************************************************************//**
+ * @brief       Store a value as varint (7 bits per byte, LSB first)
+ * @param[in]   p       Destination
+ * @param[in]   v       Value to store
+ * @return      Position after the last byte written
+ **********************************************************************/
+static UINT8 *putVarint(UINT8 *p, UINT32 v)
+{
+while (v >= 0x80)
+    {
+    *p++ = (UINT8)(v | 0x80);
+    v >>= 7;
+    }
+
+*p++ = (UINT8)v;
+
+return p;
+}
+
+
+/*********************************************************************//**
+ * @brief       Close the current block and start the next one with a key
+ *              frame. The oldest block is overwritten when the ring is full.
+ * @return      None
+ **********************************************************************/
+static void openBlock(void)
+{
+UINT8 *p;
+
+putU16(&trace.pBuf[trace.Block * LEON_TRACE_BLOCK_SIZE], trace.Pos);
+
+trace.Block = (trace.Block + 1 == trace.NumBlocks) ? 0 : (trace.Block + 1);
+if (trace.Filled < trace.NumBlocks)
+    {
+    trace.Filled++;
+    }
+
+p = &trace.pBuf[trace.Block * LEON_TRACE_BLOCK_SIZE];
+putU32(p + 2, trace.LastCycles);
+putU32(p + 6, trace.LastValue);
+trace.Pos = LEON_TRACE_KEY_SIZE;
+}
+
+
+/*********************************************************************//**
+ * @brief       Find the record tag of a register
+ * @param[in]   pReg    Register address
+ * @return      Tag without the write bit, or LEON_TRACE_NO_DEVICE if the
+ *              register is not in an attached block
+ **********************************************************************/
+static UINT32 lookupTag(const volatile UINT32 *pReg)
+{
+unsigned long off;
+UINT32 i;
+
+for (i = 0; i < trace.NumDev; i++)
+    {
+    off = (unsigned long)pReg - trace.Dev[i].Base;
+    if (off < trace.Dev[i].Size)
+        {
+        return (LEON_TRACE_TAG_DEV(i) | ((UINT32)(off >> 2) & LEON_TRACE_TAG_OFF_MASK));
+        }
+    }
+
+return LEON_TRACE_NO_DEVICE;
+}
+
+
+/*********************************************************************//**
+ * @brief       Append one record to the trace
+ * @param[in]   tag     Record tag
+ * @param[in]   value   Value read or written
+ * @return      None
+ **********************************************************************/
+static void record(UINT32 tag, UINT32 value)
+{
+UINT8 *p;
+UINT32 cycles;
+
+#ifdef LEON_TRACE_CYCLES
+cycles = LEON_TRACE_CYCLES();
+#else
+cycles = ++trace.Stamp;
+#endif
+
+if (trace.Pos + LEON_TRACE_RECORD_MAX > LEON_TRACE_BLOCK_SIZE)
+    {
+    openBlock();
+    }
+
+p = &trace.pBuf[trace.Block * LEON_TRACE_BLOCK_SIZE + trace.Pos];
+putU16(p, tag);
+p = putVarint(p + 2, cycles - trace.LastCycles);
+p = putVarint(p, value ^ trace.LastValue);
+
+trace.Pos = (UINT32)(p - &trace.pBuf[trace.Block * LEON_TRACE_BLOCK_SIZE]);
+trace.LastCycles = cycles;
+trace.LastValue = value;
+}
+
+
+/*********************************************************************//**
+ * @brief       Initialize the recorder and start recording
+ * @param[in]   pBuf    Trace storage
+ * @param[in]   size    Size of pBuf in bytes, at least one block of
+ *                      LEON_TRACE_BLOCK_SIZE bytes
+ * @return      None
+ *
+ * Note: Attached register blocks are forgotten.
+ **********************************************************************/
+void LEON_TraceInit(UINT8 *pBuf, UINT32 size)
+{
+trace.pBuf = pBuf;
+trace.NumBlocks = size / LEON_TRACE_BLOCK_SIZE;
+trace.Block = 0;
+trace.Pos = LEON_TRACE_KEY_SIZE;
+trace.Filled = 1;
+trace.LastCycles = 0;
+trace.LastValue = 0;
+trace.Stamp = 0;
+trace.NumDev = 0;
+trace.Enabled = (trace.NumBlocks != 0);
+
+if (trace.Enabled)
+    {
+    putU32(pBuf + 2, 0);
+    putU32(pBuf + 6, 0);
+    }
+}
+
+
+/*********************************************************************//**
+ * @brief       Record accesses to a register block
+ * @param[in]   base    First register of the block, e.g. a LEON_SSP_TypeDef
+ * @param[in]   size    Size of the block in bytes
+ * @param[in]   kind    LEON_TRACE_KIND_SSP, _GPIO or _OTHER
+ * @return      Device number used in the trace, or LEON_TRACE_NO_DEVICE
+ *              if LEON_TRACE_MAX_DEVICES blocks are already attached
+ **********************************************************************/
+UINT32 LEON_TraceAttach(const volatile void *base, UINT32 size, UINT32 kind)
+{
+if (trace.NumDev == LEON_TRACE_MAX_DEVICES)
+    {
+    return LEON_TRACE_NO_DEVICE;
+    }
+
+trace.Dev[trace.NumDev].Base = (unsigned long)base;
+trace.Dev[trace.NumDev].Size = size;
+trace.Dev[trace.NumDev].Kind = kind;
+
+return trace.NumDev++;
+}
+
+
+/*********************************************************************//**
+ * @brief       Pause or resume recording
+ * @param[in]   enable  0 to pause, other values to resume
+ * @return      None
+ **********************************************************************/
+void LEON_TraceEnable(UINT32 enable)
+{
+trace.Enabled = (enable != 0) && (trace.NumBlocks != 0);
+}
+
+
+/*********************************************************************//**
+ * @brief       Read a register and record the access
+ * @param[in]   pReg    Register to read
+ * @return      Value read
+ **********************************************************************/
+UINT32 LEON_TraceRead(const volatile UINT32 *pReg)
+{
+UINT32 value;
+UINT32 tag;
+
+LEON_TRACE_LOCK();
+
+value = *pReg;
+
+if (trace.Enabled && ((tag = lookupTag(pReg)) != LEON_TRACE_NO_DEVICE))
+    {
+    record(tag, value);
+    }
+
+LEON_TRACE_UNLOCK();
+
+return value;
+}
+
+
+/*********************************************************************//**
+ * @brief       Write a register and record the access
+ * @param[in]   pReg    Register to write
+ * @param[in]   value   Value to write
+ * @return      None
+ **********************************************************************/
+void LEON_TraceWrite(volatile UINT32 *pReg, UINT32 value)
+{
+UINT32 tag;
+
+LEON_TRACE_LOCK();
+
+*pReg = value;
+
+if (trace.Enabled && ((tag = lookupTag(pReg)) != LEON_TRACE_NO_DEVICE))
+    {
+    record(tag | LEON_TRACE_TAG_WRITE, value);
+    }
+
+LEON_TRACE_UNLOCK();
+}
+
+
+/*********************************************************************//**
+ * @brief       Write the trace, oldest block first, through a callback
+ * @param[in]   pWrite  Called for each piece of the dump
+ * @param[in]   pArg    Passed to pWrite
+ * @return      Number of bytes passed to pWrite
+ **********************************************************************/
+UINT32 LEON_TraceDump(void (*pWrite)(const UINT8 *pData, UINT32 len, void *pArg), void *pArg)
+{
+UINT8 hdr[12];
+UINT32 total = 0;
+UINT32 block;
+UINT32 i;
+
+if (trace.NumBlocks == 0)
+    {
+    return 0;
+    }
+
+putU16(&trace.pBuf[trace.Block * LEON_TRACE_BLOCK_SIZE], trace.Pos);
+
+hdr[0] = 'L';
+hdr[1] = 'T';
+hdr[2] = 'R';
+hdr[3] = 'C';
+hdr[4] = LEON_TRACE_VERSION;
+hdr[5] = (UINT8)trace.NumDev;
+putU16(&hdr[6], LEON_TRACE_BLOCK_SIZE);
+putU32(&hdr[8], trace.Filled);
+pWrite(hdr, 12, pArg);
+total += 12;
+
+for (i = 0; i < trace.NumDev; i++)
+    {
+    hdr[0] = (UINT8)trace.Dev[i].Kind;
+    putU32(&hdr[1], (UINT32)trace.Dev[i].Base);
+    putU32(&hdr[5], trace.Dev[i].Size);
+    pWrite(hdr, 9, pArg);
+    total += 9;
+    }
+
+block = (trace.Filled < trace.NumBlocks) ? 0 : (trace.Block + 1) % trace.NumBlocks;
+
+for (i = 0; i < trace.Filled; i++)
+    {
+    pWrite(&trace.pBuf[block * LEON_TRACE_BLOCK_SIZE], LEON_TRACE_BLOCK_SIZE, pArg);
+    total += LEON_TRACE_BLOCK_SIZE;
+    block = (block + 1 == trace.NumBlocks) ? 0 : (block + 1);
+    }
+
+return total;
+}
+
+#endif /* LEON_TRACE */
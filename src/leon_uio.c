@@ -0,0 +1,272 @@
+
+/* Includes ------------------------------------------------------------------- */
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include "common.h"
+#include "leon_uio.h"
+#include "leon_trace.h"
+#include "HAL.h"
+
+static Status mapWindow(UIO_DEV_Type *pDev, const char *path, int flags,
+                        off_t mapOffset, UINT32 offset, UINT32 size);
+static INT32 remainingMs(const struct timespec *pDeadline);
+
+
+
+/*********************************************************************//**
+ * @brief       Open a file and map a register window from it
+ * @param[in]   pDev        Window descriptor to fill
+ * @param[in]   path        File to map
+ * @param[in]   flags       Additional open() flags
+ * @param[in]   mapOffset   Page aligned mmap() offset
+ * @param[in]   offset      Offset of the first register from mapOffset
+ * @param[in]   size        Size of the register window in bytes
+ * @return      SUCCESS or ERROR
+ **********************************************************************/
+static Status mapWindow(UIO_DEV_Type *pDev, const char *path, int flags,
+                        off_t mapOffset, UINT32 offset, UINT32 size)
+{
+void *map;
+
+pDev->Fd = open(path, O_RDWR | flags);
+if (pDev->Fd < 0)
+    {
+    return ERROR;
+    }
+
+pDev->MapSize = offset + size;
+map = mmap(NULL, pDev->MapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+           pDev->Fd, mapOffset);
+if (map == MAP_FAILED)
+    {
+    close(pDev->Fd);
+    pDev->Fd = -1;
+    return ERROR;
+    }
+
+pDev->pMap = map;
+pDev->pRegs = (volatile UINT32 *)((UINT8 *)map + offset);
+
+return SUCCESS;
+}
+
+
+/*********************************************************************//**
+ * @brief       Milliseconds left until a CLOCK_MONOTONIC deadline
+ * @param[in]   pDeadline   Deadline
+ * @return      Time left rounded up, 0 once the deadline has passed
+ **********************************************************************/
+static INT32 remainingMs(const struct timespec *pDeadline)
+{
+struct timespec now;
+long long ns;
+
+clock_gettime(CLOCK_MONOTONIC, &now);
+
+ns = (long long)(pDeadline->tv_sec - now.tv_sec) * 1000000000LL +
+     (pDeadline->tv_nsec - now.tv_nsec);
+
+return (ns <= 0) ? 0 : (INT32)((ns + 999999) / 1000000);
+}
+
+
+/*********************************************************************//**
+ * @brief       Map a register window exported by a UIO device
+ * @param[in]   pDev        Window descriptor to fill
+ * @param[in]   path        UIO device, e.g. "/dev/uio0"
+ * @param[in]   mapIndex    UIO map number (maps/mapN in sysfs)
+ * @param[in]   offset      Offset of the registers inside the map
+ *                          (maps/mapN/offset in sysfs)
+ * @param[in]   size        Size of the register window in bytes
+ * @return      SUCCESS or ERROR
+ **********************************************************************/
+Status UIO_OpenUIO(UIO_DEV_Type *pDev, const char *path, UINT32 mapIndex,
+                   UINT32 offset, UINT32 size)
+{
+/* UIO selects map N with an mmap() offset of N pages */
+off_t page = (off_t)sysconf(_SC_PAGESIZE);
+
+pDev->IsUIO = TRUE;
+
+return mapWindow(pDev, path, 0, (off_t)mapIndex * page, offset, size);
+}
+
+
+/*********************************************************************//**
+ * @brief       Map a register window at a physical base address through
+ *              /dev/mem, or at a file offset of any mappable file
+ * @param[in]   pDev        Window descriptor to fill
+ * @param[in]   path        "/dev/mem", or a file backing a fake window
+ * @param[in]   base        Physical base address (file offset)
+ * @param[in]   size        Size of the register window in bytes
+ * @return      SUCCESS or ERROR
+ **********************************************************************/
+Status UIO_OpenMem(UIO_DEV_Type *pDev, const char *path, UINT32 base, UINT32 size)
+{
+UINT32 page = (UINT32)sysconf(_SC_PAGESIZE);
+UINT32 aligned = base & ~(page - 1);
+
+pDev->IsUIO = FALSE;
+
+return mapWindow(pDev, path, O_SYNC, (off_t)aligned, base - aligned, size);
+}
+
+
+/*********************************************************************//**
+ * @brief       Unmap a register window and close its file
+ * @param[in]   pDev        Window descriptor
+ * @return      None
+ **********************************************************************/
+void UIO_Close(UIO_DEV_Type *pDev)
+{
+if (pDev->Fd >= 0)
+    {
+    munmap(pDev->pMap, pDev->MapSize);
+    close(pDev->Fd);
+    }
+
+pDev->Fd = -1;
+pDev->pMap = NULL;
+pDev->pRegs = NULL;
+}
+
+
+/*********************************************************************//**
+ * @brief       Get the SSP register block of a mapped window
+ * @param[in]   pDev        Window descriptor
+ * @return      Pointer to be passed to the SSP driver functions
+ **********************************************************************/
+LEON_SSP_TypeDef *UIO_GetSSP(UIO_DEV_Type *pDev)
+{
+return ((LEON_SSP_TypeDef *)pDev->pRegs);
+}
+
+
+/*********************************************************************//**
+ * @brief       Get the GPIO register block of a mapped window
+ * @param[in]   pDev        Window descriptor
+ * @return      Pointer to be passed to the GPIO driver functions
+ **********************************************************************/
+LEON_GPIO_TypeDef *UIO_GetGPIO(UIO_DEV_Type *pDev)
+{
+return ((LEON_GPIO_TypeDef *)pDev->pRegs);
+}
+
+
+/*********************************************************************//**
+ * @brief       Re-enable the interrupt of a UIO device. The UIO core masks
+ *              the interrupt each time it fires.
+ * @param[in]   pDev        Window descriptor
+ * @return      SUCCESS or ERROR
+ **********************************************************************/
+Status UIO_EnableIRQ(UIO_DEV_Type *pDev)
+{
+UINT32 enable = UIO_IRQ_ENABLE;
+
+if (!pDev->IsUIO)
+    {
+    return ERROR;
+    }
+
+return (write(pDev->Fd, &enable, sizeof(enable)) == sizeof(enable)) ? SUCCESS : ERROR;
+}
+
+
+/*********************************************************************//**
+ * @brief       Sleep until the UIO device reports an interrupt
+ * @param[in]   pDev        Window descriptor
+ * @param[in]   timeout_ms  Timeout in milliseconds, or UIO_WAIT_FOREVER
+ * @return      Total interrupt count reported by the UIO core, 0 on
+ *              timeout and -1 on error
+ **********************************************************************/
+INT32 UIO_WaitIRQ(UIO_DEV_Type *pDev, INT32 timeout_ms)
+{
+struct pollfd pfd;
+UINT32 count;
+int ret;
+
+if (!pDev->IsUIO)
+    {
+    return (-1);
+    }
+
+pfd.fd = pDev->Fd;
+pfd.events = POLLIN;
+
+ret = poll(&pfd, 1, timeout_ms);
+if (ret <= 0)
+    {
+    return ret;
+    }
+
+if (read(pDev->Fd, &count, sizeof(count)) != sizeof(count))
+    {
+    return (-1);
+    }
+
+return ((INT32)count);
+}
+
+
+/*********************************************************************//**
+ * @brief       Wait for SSP event bits without polling the core. The
+ *              matching MASK bits are set for the duration of the wait and
+ *              the thread sleeps in the UIO device until the core interrupts.
+ * @param[in]   pDev        UIO window the SSP core is mapped from
+ * @param[in]   SSPx        SSP peripheral obtained by UIO_GetSSP()
+ * @param[in]   events      SSP_EVENT_xxx bits to wait for (any of them)
+ * @param[in]   timeout_ms  Timeout in milliseconds for the whole wait,
+ *                          or UIO_WAIT_FOREVER
+ * @return      SUCCESS when one of the events is set, ERROR on timeout
+ *              or if the window has no interrupt
+ *
+ * Note: Event and mask registers share the same bit layout. Interrupts of
+ * other sources of the core do not extend the timeout.
+ **********************************************************************/
+Status UIO_SSP_WaitEvent(UIO_DEV_Type *pDev, LEON_SSP_TypeDef *SSPx,
+                         UINT32 events, INT32 timeout_ms)
+{
+Status ret = SUCCESS;
+UINT32 mask = LEON_RD(SSPx->MASK);
+struct timespec deadline;
+INT32 left = timeout_ms;
+
+if (timeout_ms != UIO_WAIT_FOREVER)
+    {
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+        {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+LEON_WR(SSPx->MASK, mask | events);
+
+while (!(LEON_RD(SSPx->EVENT) & events))
+    {
+    if (timeout_ms != UIO_WAIT_FOREVER)
+        {
+        left = remainingMs(&deadline);
+        }
+
+    /* Event is checked again after the enable to close the race with an
+       interrupt that fired before the UIO interrupt was unmasked */
+    if ((UIO_EnableIRQ(pDev) != SUCCESS) ||
+        (!(LEON_RD(SSPx->EVENT) & events) && (UIO_WaitIRQ(pDev, left) <= 0)))
+        {
+        ret = ERROR;
+        break;
+        }
+    }
+
+LEON_WR(SSPx->MASK, mask);
+
+return ret;
+}
@@ -0,0 +1,412 @@
+/*
+ * Register access trace replay.
+ *
+ * Reads a trace written by LEON_TraceDump() (see inc/leon_trace.h), replays
+ * it into a model of the values of the traced SSP/GPIO registers and
+ * reports:
+ * - the access timeline with the recorded cycle stamps (-v)
+ * - per register access counts
+ * - redundant accesses: reads of configuration registers whose value is
+ *   already known and writes that do not change the modeled value
+ * - read-modify-write hot spots: a read directly followed, in the whole
+ *   trace, by a write of the same register
+ *
+ * Only register values are modeled. The tool does not model FIFOs, transfer
+ * or bus timing: cycle figures are the stamps taken on the target, and a
+ * trace recorded without a cycle counter only has access counts.
+ *
+ * Build on a Linux host:
+ *   make -C bench leon_trace_replay
+ * or
+ *   cc -Iinc -o leon_trace_replay tools/leon_trace_replay.c
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t  UINT8;
+typedef uint16_t UINT16;
+typedef uint32_t UINT32;
+
+#include "leon_trace.h"
+
+#define MAX_WORDS       (LEON_TRACE_TAG_OFF_MASK + 1)
+#define HOTSPOT_LINES   (10)
+
+/** @brief Modeled register */
+typedef struct {
+    UINT32 Value;              /** Last value seen                         */
+    UINT32 Known;              /** Value is valid                          */
+    UINT32 Reads;
+    UINT32 Writes;
+    UINT32 RedundantReads;
+    UINT32 RedundantWrites;
+    UINT32 RMW;
+} REG_Type;
+
+/** @brief Modeled register block */
+typedef struct {
+    UINT32 Kind;
+    UINT32 Base;
+    UINT32 Size;
+    REG_Type *pReg;
+} DEV_Type;
+
+static const char *sspNames[] = {
+    "CAP", NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+    "MODE", "EVENT", "MASK", "CMD", "TX", "RX", "SLAVESEL", "AUTOSLAVESEL",
+    "AMCONFIG", "AMPERIOD"
+};
+
+static const char *gpioNames[] = {
+    "IO_DATA", "IO_OUTPUT", "IO_DIR", "INT_MASK", "INT_POL", "INT_EDGE",
+    "BYPASS", "CAP"
+};
+
+static DEV_Type dev[LEON_TRACE_MAX_DEVICES];
+static UINT32 numDev;
+static UINT32 lastReadTag = LEON_TRACE_NO_DEVICE;   /** Tag of the previous
+                                                    record if it was a read */
+
+
+
+/*********************************************************************//**
+ * @brief       Read little endian integers
+ **********************************************************************/
+static UINT32 getU16(const UINT8 *p)
+{
+return (UINT32)p[0] | ((UINT32)p[1] << 8);
+}
+
+static UINT32 getU32(const UINT8 *p)
+{
+return getU16(p) | (getU16(p + 2) << 16);
+}
+
+
+/*********************************************************************//**
+ * @brief       Read a varint
+ * @param[in]   p       Position of the varint
+ * @param[in]   end     End of the data
+ * @param[out]  pValue  Decoded value
+ * @return      Position after the varint, or NULL if truncated
+ **********************************************************************/
+static const UINT8 *getVarint(const UINT8 *p, const UINT8 *end, UINT32 *pValue)
+{
+UINT32 v = 0;
+UINT32 shift = 0;
+
+while (p < end)
+    {
+    v |= (UINT32)(*p & 0x7F) << shift;
+    if (!(*p++ & 0x80))
+        {
+        *pValue = v;
+        return p;
+        }
+    shift += 7;
+    }
+
+return NULL;
+}
+
+
+/*********************************************************************//**
+ * @brief       Name of a register
+ **********************************************************************/
+static const char *regName(const DEV_Type *pDev, UINT32 word)
+{
+static char buf[16];
+
+if ((pDev->Kind == LEON_TRACE_KIND_SSP) && (word < sizeof(sspNames) / sizeof(sspNames[0])) &&
+    (sspNames[word] != NULL))
+    {
+    return sspNames[word];
+    }
+
+if ((pDev->Kind == LEON_TRACE_KIND_GPIO) && (word < sizeof(gpioNames) / sizeof(gpioNames[0])))
+    {
+    return gpioNames[word];
+    }
+
+snprintf(buf, sizeof(buf), "+0x%03X", word * 4);
+
+return buf;
+}
+
+
+/*********************************************************************//**
+ * @brief       Tell if a register changes without being written, so that
+ *              reading it again is never redundant
+ **********************************************************************/
+static int isStatus(const DEV_Type *pDev, UINT32 word)
+{
+if (pDev->Kind == LEON_TRACE_KIND_SSP)
+    {
+    /* EVENT, RX and the AM receive registers */
+    return (word == 9) || (word == 13) || (word >= 0x100);
+    }
+
+if (pDev->Kind == LEON_TRACE_KIND_GPIO)
+    {
+    return (word == 0);
+    }
+
+return 1;
+}
+
+
+/*********************************************************************//**
+ * @brief       Tell if writing a register has a side effect, so that
+ *              writing the same value again is never redundant
+ **********************************************************************/
+static int hasSideEffect(const DEV_Type *pDev, UINT32 word)
+{
+if (pDev->Kind == LEON_TRACE_KIND_SSP)
+    {
+    /* EVENT (write 1 to clear), CMD, TX and the AM transmit registers */
+    return (word == 9) || (word == 11) || (word == 12) || (word >= 0x80);
+    }
+
+return (pDev->Kind != LEON_TRACE_KIND_GPIO);
+}
+
+
+/*********************************************************************//**
+ * @brief       Apply one access to the model
+ **********************************************************************/
+static void replay(UINT32 tag, UINT32 cycles, UINT32 delta, UINT32 value, int verbose)
+{
+UINT32 d = (tag >> 11) & 0xF;
+UINT32 word = tag & LEON_TRACE_TAG_OFF_MASK;
+int write = (tag & LEON_TRACE_TAG_WRITE) != 0;
+DEV_Type *pDev;
+REG_Type *pReg;
+
+if ((d >= numDev) || (word * 4 >= dev[d].Size))
+    {
+    fprintf(stderr, "record for unknown register dev %u word %u\n", d, word);
+    lastReadTag = LEON_TRACE_NO_DEVICE;
+    return;
+    }
+
+pDev = &dev[d];
+pReg = &pDev->pReg[word];
+
+if (verbose)
+    {
+    printf("%10u +%-7u  %s%u.%-12s %c 0x%08X\n", cycles, delta,
+           (pDev->Kind == LEON_TRACE_KIND_SSP) ? "SSP" :
+           (pDev->Kind == LEON_TRACE_KIND_GPIO) ? "GPIO" : "DEV", d,
+           regName(pDev, word), write ? 'W' : 'R', value);
+    }
+
+if (write)
+    {
+    pReg->Writes++;
+    if (lastReadTag == (tag & ~LEON_TRACE_TAG_WRITE))
+        {
+        pReg->RMW++;
+        }
+    if (pReg->Known && (pReg->Value == value) && !hasSideEffect(pDev, word))
+        {
+        pReg->RedundantWrites++;
+        }
+    /* GPIO IO_OUTPUT/IO_DIR and SSP configuration registers keep the value */
+    pReg->Known = !hasSideEffect(pDev, word);
+    lastReadTag = LEON_TRACE_NO_DEVICE;
+    }
+else
+    {
+    pReg->Reads++;
+    if (pReg->Known && (pReg->Value == value) && !isStatus(pDev, word))
+        {
+        pReg->RedundantReads++;
+        }
+    pReg->Known = !isStatus(pDev, word);
+    lastReadTag = tag;
+    }
+
+pReg->Value = value;
+}
+
+
+/*********************************************************************//**
+ * @brief       Compare registers by read-modify-write count
+ **********************************************************************/
+static const REG_Type *sortBase;
+
+static int cmpRMW(const void *a, const void *b)
+{
+UINT32 ra = sortBase[*(const UINT32 *)a].RMW;
+UINT32 rb = sortBase[*(const UINT32 *)b].RMW;
+
+return (ra < rb) - (ra > rb);
+}
+
+
+/*********************************************************************//**
+ * @brief       Print the per register statistics and RMW hot spots
+ **********************************************************************/
+static void report(UINT32 first, UINT32 last, UINT32 records)
+{
+UINT32 redundant = 0;
+UINT32 rmw = 0;
+UINT32 d;
+UINT32 w;
+UINT32 n;
+UINT32 *order;
+
+printf("\nrecords %u, span %u cycles, %.1f cycles/access\n", records, last - first,
+       records ? (double)(last - first) / records : 0.0);
+
+for (d = 0; d < numDev; d++)
+    {
+    printf("\n%s%u @ 0x%08X\n", (dev[d].Kind == LEON_TRACE_KIND_SSP) ? "SSP" :
+           (dev[d].Kind == LEON_TRACE_KIND_GPIO) ? "GPIO" : "DEV", d, dev[d].Base);
+    printf("  %-12s %8s %8s %8s %8s %8s\n", "register", "reads", "writes",
+           "red.rd", "red.wr", "rmw");
+
+    n = dev[d].Size / 4;
+    for (w = 0; w < n; w++)
+        {
+        REG_Type *r = &dev[d].pReg[w];
+        if (r->Reads || r->Writes)
+            {
+            printf("  %-12s %8u %8u %8u %8u %8u\n", regName(&dev[d], w), r->Reads,
+                   r->Writes, r->RedundantReads, r->RedundantWrites, r->RMW);
+            redundant += r->RedundantReads + r->RedundantWrites;
+            rmw += r->RMW;
+            }
+        }
+
+    order = malloc(n * sizeof(UINT32));
+    for (w = 0; w < n; w++)
+        {
+        order[w] = w;
+        }
+    sortBase = dev[d].pReg;
+    qsort(order, n, sizeof(UINT32), cmpRMW);
+
+    for (w = 0; (w < n) && (w < HOTSPOT_LINES) && dev[d].pReg[order[w]].RMW; w++)
+        {
+        printf("  hot spot: %-12s %u read-modify-write\n", regName(&dev[d], order[w]),
+               dev[d].pReg[order[w]].RMW);
+        }
+    free(order);
+    }
+
+printf("\nredundant accesses %u, read-modify-write %u\n", redundant, rmw);
+}
+
+
+int main(int argc, char *argv[])
+{
+const char *path = NULL;
+int verbose = 0;
+FILE *f;
+UINT8 hdr[12];
+UINT8 *block;
+const UINT8 *p;
+const UINT8 *end;
+UINT32 blockSize;
+UINT32 numBlocks;
+UINT32 cycles = 0;
+UINT32 value;
+UINT32 delta;
+UINT32 xor;
+UINT32 tag;
+UINT32 first = 0;
+UINT32 records = 0;
+UINT32 b;
+int i;
+
+for (i = 1; i < argc; i++)
+    {
+    if (strcmp(argv[i], "-v") == 0)
+        verbose = 1;
+    else
+        path = argv[i];
+    }
+
+if (path == NULL)
+    {
+    fprintf(stderr, "usage: %s [-v] trace.bin\n", argv[0]);
+    return 2;
+    }
+
+f = fopen(path, "rb");
+if ((f == NULL) || (fread(hdr, 1, 12, f) != 12) || memcmp(hdr, "LTRC", 4) ||
+    (hdr[4] != LEON_TRACE_VERSION) || (hdr[5] > LEON_TRACE_MAX_DEVICES))
+    {
+    fprintf(stderr, "%s: not a version %u trace\n", path, LEON_TRACE_VERSION);
+    return 1;
+    }
+
+numDev = hdr[5];
+blockSize = getU16(&hdr[6]);
+numBlocks = getU32(&hdr[8]);
+
+for (b = 0; b < numDev; b++)
+    {
+    if (fread(hdr, 1, 9, f) != 9)
+        {
+        fprintf(stderr, "%s: truncated device table\n", path);
+        return 1;
+        }
+    dev[b].Kind = hdr[0];
+    dev[b].Base = getU32(&hdr[1]);
+    dev[b].Size = getU32(&hdr[5]);
+    if (dev[b].Size > MAX_WORDS * 4)
+        dev[b].Size = MAX_WORDS * 4;
+    dev[b].pReg = calloc(dev[b].Size / 4 + 1, sizeof(REG_Type));
+    }
+
+block = malloc(blockSize);
+
+for (b = 0; b < numBlocks; b++)
+    {
+    if (fread(block, 1, blockSize, f) != blockSize)
+        {
+        fprintf(stderr, "%s: truncated block %u\n", path, b);
+        break;
+        }
+
+    end = block + ((getU16(block) < blockSize) ? getU16(block) : blockSize);
+    p = block + LEON_TRACE_KEY_SIZE;
+    cycles = getU32(block + 2);
+    value = getU32(block + 6);
+
+    while (p + 2 < end)
+        {
+        tag = getU16(p);
+        p = getVarint(p + 2, end, &delta);
+        if ((p == NULL) || ((p = getVarint(p, end, &xor)) == NULL))
+            {
+            fprintf(stderr, "%s: corrupt record in block %u\n", path, b);
+            break;
+            }
+
+        cycles += delta;
+        value ^= xor;
+
+        if (records++ == 0)
+            {
+            first = cycles;
+            delta = 0;
+            }
+
+        replay(tag, cycles, delta, value, verbose);
+        }
+    }
+
+fclose(f);
+free(block);
+
+report(first, cycles, records);
+
+return 0;
+}